@@ -38,6 +38,8 @@ HEADERS += dataeditorwidget.h \
            fittingparameterchart.h \
            modelmanager.h \
            modelparameter.h \
+           modelsolver.h \
+           modelsweepdialog.h \
            modelselect.h \
            modelwidget01-06.h \
            mousezoom.h \
@@ -70,6 +72,7 @@ FORMS += dataeditorwidget.ui \
          fittingdatadialog.ui \
          fittingpage.ui \
          modelselect.ui \
+         modelsweepdialog.ui \
          modelwidget01-06.ui \
          newprojectdialog.ui \
          paramselectdialog.ui \
@@ -101,6 +104,8 @@ SOURCES += \
            fittingparameterchart.cpp \
            modelmanager.cpp \
            modelparameter.cpp \
+           modelsolver.cpp \
+           modelsweepdialog.cpp \
            modelselect.cpp \
            modelwidget01-06.cpp \
            mousezoom.cpp \
@@ -127,8 +132,8 @@ SOURCES += \
 
 RESOURCES += resource.qrc
 
-INCLUDEPATH += D:/08YYYXXX/eigen-3.3.8
-INCLUDEPATH += D:/08YYYXXX/boost_1_89_0
+# 模型计算内核 (无界面依赖，同时提供 Eigen 头文件路径)
+include(modelkernel.pri)
 
 
 # 警告设置
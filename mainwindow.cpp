@@ -15,10 +15,12 @@
 #include "wt_projectwidget.h"
 #include "dataeditorwidget.h"
 #include "modelmanager.h"
+#include "modelsolver.h"
 #include "modelparameter.h"
 #include "wt_plottingwidget.h"
 #include "fittingpage.h"
 #include "settingswidget.h"
+#include "wt_fittingwidget.h"
 
 #include <QDateTime>
 #include <QMessageBox>
@@ -197,6 +199,12 @@ void MainWindow::init()
     ui->verticalLayout_3->addWidget(m_SettingsWidget);
     connect(m_SettingsWidget, &SettingsWidget::settingsChanged,
             this, &MainWindow::onSystemSettingsChanged);
+    // 将已保存的模型计算设置应用到计算服务
+    ModelSolver::setInversionThreadCount(m_SettingsWidget->getCalcThreadCount());
+    ModelSolver::setInversionMethod((ModelInversion::Method)m_SettingsWidget->getInversionMethod());
+    ModelSolver::setCacheLimit(m_SettingsWidget->getCalcCacheLimit());
+    ModelSolver::setAlignedTimeSteps(m_SettingsWidget->isAlignedTimeGrid());
+    FittingWidget::setEvaluationThreadCount(m_SettingsWidget->getFitThreadCount());
 
     // 调用各模块的初始化钩子（打印日志）
     initProjectForm();
@@ -438,6 +446,13 @@ void MainWindow::onFittingProgressChanged(int progress)
 void MainWindow::onSystemSettingsChanged()
 {
     qDebug() << "系统设置已变更";
+    if (m_SettingsWidget) {
+        ModelSolver::setInversionThreadCount(m_SettingsWidget->getCalcThreadCount());
+        ModelSolver::setInversionMethod((ModelInversion::Method)m_SettingsWidget->getInversionMethod());
+        ModelSolver::setCacheLimit(m_SettingsWidget->getCalcCacheLimit());
+        ModelSolver::setAlignedTimeSteps(m_SettingsWidget->isAlignedTimeGrid());
+        FittingWidget::setEvaluationThreadCount(m_SettingsWidget->getFitThreadCount());
+    }
 }
 
 void MainWindow::onPerformanceSettingsChanged() {}
@@ -0,0 +1,1110 @@
+/*
+ * 文件名: modelbench.cpp
+ * 文件作用: 模型计算内核基准测试程序 (控制台，仅依赖 ModelKernel)
+ * 功能描述:
+ * 1. 每个基准为一个独立函数，按名称从命令行选择运行，不带参数时列出全部基准。
+ * 2. inversion: 比较 Stehfest / Talbot / de Hoog / Euler 各阶数的拉普拉斯计算次数、精度、误差估计与耗时。
+ *    参考解取 de Hoog (M=24)，并与 Talbot (M=32) 交叉校验。
+ * 3. derivative: 比较 s·p̄(s) 直接反演的对数导数与稀疏网格上对数差分导数的误差，
+ *    参考导数同样取 de Hoog (M=24)，并用密网格上的中心差分校验。
+ * 4. grid: 在大量请求时间点上比较自适应粗网格 + 对数-对数插值 (ModelCurveGrid) 与逐点计算的耗时与误差，
+ *    实际误差超过 relTol 时以退出码 1 标出 (网格达不到要求而改为逐点计算的标为 direct)。
+ * 5. master: 模拟雅可比矩阵中比例参数 (phi、mu、Ct、q、B、h) 的中心差分，比较逐次完整计算与
+ *    无因次主曲线缓存 (平移 + 插值) 的耗时、缓存命中、逐点计算次数与误差，实际误差超过 relTol 时以退出码 1 标出。
+ * 6. response: 模拟雅可比矩阵中 cD、S、gamaD 列的中心差分，比较不使用与使用储层响应缓存
+ *    (ModelResponseCache) 的耗时与结果差异 (应逐位一致)。
+ * 7. laplace: 单次拉普拉斯空间计算 flaplace_composite 的耗时 (实数 Stehfest 节点与复数 Talbot 节点)，逐模型列出。
+ * 8. alloc: 以计数分配器 (替换全局 operator new) 统计单次拉普拉斯计算的堆分配次数，
+ *    nf <= ModelKernel::MaxStackFractures 时应为 0，超出时报告非零并以退出码 1 标出违反项。
+ * 9. scaling: nf = 4 .. 256 时裂缝系统直接消元、Toeplitz 迭代求解、迭代 + 远场压缩三种方式的
+ *    单次拉普拉斯计算耗时，以及迭代结果相对直接消元的最大相对差。
+ * 10. cache: 在不同内存上限下轮流计算多组储层参数，检查拉普拉斯值缓存的占用不超过上限，
+ *     并统计命中、未命中与淘汰次数；参数不变的重复计算应全部命中。
+ * 11. aligned: 任意对数时间网格与 Stehfest 对齐网格 (ModelInversion::alignedTimes) 上一条曲线实际计算的
+ *     拉普拉斯值个数与耗时，并与逐点单独计算的结果比较 (应逐位一致)；对齐网格的点数与两端应与对数网格相同。
+ *     同时统计自适应主曲线 (插值到任意时间) 构造时的拉普拉斯计算次数。
+ * 12. batch: 逐点调用 flaplace_composite 与批量接口 (一组 z 一次调用) 的每点耗时，结果应逐位一致。
+ * 13. sweep: 多参数扫描 (ModelSweep) 的全组合与拉丁超立方工况，比较逐条串行计算与扫描引擎
+ *     (分组 + 储层响应缓存 + 线程池) 的耗时，并回读结果文件核对记录与逐条计算一致 (float 精度)，
+ *     整数参数 (nf) 的记录值应为整数。
+ * 14. fit: 从偏离真值的初值拟合带噪声的无因次曲线 (pD 与导数的对数残差)，比较原有 ×10/÷10 阻尼、
+ *     Nielsen 阻尼 + 停止判据、测地加速、Broyden 秩一更新、前向差分等 ModelFitter 设置的
+ *     迭代次数、模型计算次数、耗时、最终误差与停止原因；各设置都应停在与原有迭代方式相同的极小值。
+ *     初值取真值到远初值连线上的一点 (start = 1 为远初值，此时 Broyden 各设置停在另外的局部极小值，判为失败)。
+ * 15. multistart: 从远离真值的初值比较单起点 LM 与多起点拟合 (拉丁超立方起点、逐轮淘汰、精修)，
+ *     列出排序后的候选解，并检查单线程与多线程结果一致。
+ * 16. evolution: 同一问题上以低精度模型 (Stehfest N = 4) 做差分进化，最好个体再以 N = 8 的 LM 精修，
+ *     与单起点 LM 比较最终误差与模型计算次数，并检查单线程与多线程的进化结果一致。
+ */
+
+#include "modelkernel.h"
+#include "modelcurvegrid.h"
+#include "modelfitter.h"
+#include "modelresponsecache.h"
+#include "modelsweep.h"
+#include "modelthreadpool.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+// 计数分配器: 程序内全部 operator new 经过此处。普通、数组与带长度的各版本整套替换，
+// 统一由 malloc 分配、free 释放
+static std::atomic<long long> g_allocations(0);
+
+static void* countedAllocate(std::size_t size)
+{
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+typedef int (*BenchFunc)(int argc, char** argv);
+
+struct Bench
+{
+    const char* name;
+    const char* usage;
+    BenchFunc func;
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<double> logTimes(int count, double startExp, double endExp)
+{
+    std::vector<double> t(count);
+    for (int i = 0; i < count; ++i) t[i] = std::pow(10.0, startExp + (endExp - startExp) * i / (count - 1));
+    return t;
+}
+
+// 基准使用的默认模型参数 (与界面默认值同量级，裂缝互不重叠)
+ModelContext benchContext(ModelKernel::ModelType type, int nf)
+{
+    ModelContext ctx;
+    ctx.type = type;
+    ctx.nf = nf;
+    ctx.LfD = std::min(0.1, 0.4 / std::max(nf, 1));
+    ctx.reD = ModelKernel::isInfinite(type) ? 0.0 : 10.0;
+    ctx.cD = ModelKernel::hasStorage(type) ? 0.01 : 0.0;
+    ctx.S = ModelKernel::hasStorage(type) ? 1.0 : 0.0;
+    ctx.gamaD = 0.02;
+    return ctx;
+}
+
+// floorFraction > 0 时分母不小于 floorFraction * max|b| (用于会趋于 0 的导数曲线)
+double maxRelativeDiff(const std::vector<double>& a, const std::vector<double>& b, double floorFraction = 0.0)
+{
+    double scale = 0.0;
+    for (double v : b) scale = std::max(scale, std::abs(v));
+    double floorValue = std::max(floorFraction * scale, 1e-300);
+    double m = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) m = std::max(m, std::abs(a[i] - b[i]) / std::max(std::abs(b[i]), floorValue));
+    return m;
+}
+
+// ---------------- inversion ----------------
+int benchInversion(int argc, char** argv)
+{
+    int nf = argc > 0 ? std::atoi(argv[0]) : 4;
+    const std::vector<double> tD = logTimes(40, -3.0, 5.0);
+
+    struct Case { ModelInversion::Method method; int order; };
+    const Case cases[] = {
+        { ModelInversion::Stehfest, 4 }, { ModelInversion::Stehfest, 8 }, { ModelInversion::Stehfest, 12 },
+        { ModelInversion::Talbot, 12 }, { ModelInversion::Talbot, 16 }, { ModelInversion::Talbot, 24 },
+        { ModelInversion::DeHoog, 5 }, { ModelInversion::DeHoog, 8 }, { ModelInversion::DeHoog, 10 },
+        { ModelInversion::Euler, 5 }, { ModelInversion::Euler, 10 }, { ModelInversion::Euler, 15 }
+    };
+
+    std::printf("inversion benchmark: nf = %d, %d time points (tD = 1e-3 .. 1e5)\n", nf, (int)tD.size());
+    for (int t = ModelKernel::Model_1; t <= ModelKernel::Model_6; ++t) {
+        ModelContext ctx = benchContext((ModelKernel::ModelType)t, nf);
+
+        std::vector<double> ref, check;
+        ctx.inversionMethod = ModelInversion::DeHoog; ctx.inversionOrder = 24;
+        ModelKernel::calculatePD(tD, ctx, ref);
+        ctx.inversionMethod = ModelInversion::Talbot; ctx.inversionOrder = 32;
+        ModelKernel::calculatePD(tD, ctx, check);
+        std::printf("\nModel_%d (reference de Hoog M=24, agrees with Talbot M=32 to %.1e)\n", t + 1, maxRelativeDiff(check, ref));
+        std::printf("  %-10s %5s %11s %12s %12s %10s\n", "method", "order", "evals/point", "max rel err", "max est err", "time ms");
+
+        for (const Case& c : cases) {
+            ctx.inversionMethod = c.method;
+            ctx.inversionOrder = c.order;
+            ctx.stehfestN = (c.method == ModelInversion::Stehfest) ? c.order : 4;
+            std::vector<double> pd;
+            InversionReport report;
+            auto start = std::chrono::steady_clock::now();
+            ModelKernel::calculatePD(tD, ctx, pd, &report);
+            double ms = elapsedMs(start);
+            double maxRelEst = 0.0;
+            for (size_t i = 0; i < pd.size(); ++i) maxRelEst = std::max(maxRelEst, report.errorEstimate[i] / std::max(std::abs(ref[i]), 1e-300));
+            std::printf("  %-10s %5d %11.1f %12.2e %12.2e %10.2f\n", ModelInversion::methodName(c.method), c.order,
+                        (double)report.evaluations / tD.size(), maxRelativeDiff(pd, ref), maxRelEst, ms);
+        }
+    }
+    return 0;
+}
+
+// ---------------- derivative ----------------
+// 对数网格上的三点差分 dp/dln(t) (与 Bourdet 导数 L -> 0 时一致)，端点用单侧差分
+std::vector<double> logDifference(const std::vector<double>& t, const std::vector<double>& p)
+{
+    int n = (int)t.size();
+    std::vector<double> d(n, 0.0);
+    if (n < 2) return d;
+    for (int i = 0; i < n; ++i) {
+        int a = std::max(i - 1, 0), b = std::min(i + 1, n - 1);
+        if (a == i || b == i) { d[i] = (p[b] - p[a]) / std::log(t[b] / t[a]); continue; }
+        double la = std::log(t[i] / t[a]), lb = std::log(t[b] / t[i]);
+        d[i] = ((p[i] - p[a]) / la * lb + (p[b] - p[i]) / lb * la) / (la + lb);
+    }
+    return d;
+}
+
+// 定压边界晚期导数指数衰减到 0，相对误差的分母取不小于 1e-3 * max|导数|
+const double DerivativeFloor = 1e-3;
+
+int benchDerivative(int argc, char** argv)
+{
+    int nf = argc > 0 ? std::atoi(argv[0]) : 4;
+    const int pointsPerDecade[] = { 2, 5, 10 };
+
+    std::printf("derivative benchmark: nf = %d, tD = 1e-3 .. 1e5\n", nf);
+    for (int t = ModelKernel::Model_1; t <= ModelKernel::Model_6; ++t) {
+        ModelContext ctx = benchContext((ModelKernel::ModelType)t, nf);
+        // 有界模型晚期 pD 超过 1/gamaD 后应力敏感修正不再生效，曲线不连续，差分校验无意义
+        if (!ModelKernel::isInfinite(ctx.type)) ctx.gamaD = 0.0;
+
+        // 参考导数自身的校验: 密网格 (每十倍 40 点) 上的中心差分
+        std::vector<double> dense = logTimes(321, -3.0, 5.0), densePD, denseDeriv;
+        ctx.inversionMethod = ModelInversion::DeHoog; ctx.inversionOrder = 24;
+        ModelKernel::calculatePDAndDerivative(dense, ctx, densePD, denseDeriv);
+        std::vector<double> denseFD = logDifference(dense, densePD);
+        denseFD.front() = denseDeriv.front(); denseFD.back() = denseDeriv.back();
+        std::printf("\nModel_%d (reference de Hoog M=24, dense central difference agrees to %.1e)\n",
+                    t + 1, maxRelativeDiff(denseFD, denseDeriv, DerivativeFloor));
+        std::printf("  %-10s %5s %8s %14s %14s %10s\n", "method", "order", "pts/dec", "analytic err", "log-diff err", "time ms");
+
+        for (int ppd : pointsPerDecade) {
+            std::vector<double> tD = logTimes(8 * ppd + 1, -3.0, 5.0), refPD, refDeriv;
+            ctx.inversionMethod = ModelInversion::DeHoog; ctx.inversionOrder = 24;
+            ModelKernel::calculatePDAndDerivative(tD, ctx, refPD, refDeriv);
+
+            const ModelInversion::Method methods[] = { ModelInversion::Stehfest, ModelInversion::Talbot };
+            const int orders[] = { 8, 24 };
+            for (int m = 0; m < 2; ++m) {
+                ctx.inversionMethod = methods[m];
+                ctx.inversionOrder = orders[m];
+                ctx.stehfestN = orders[m];
+                std::vector<double> pd, deriv;
+                auto start = std::chrono::steady_clock::now();
+                ModelKernel::calculatePDAndDerivative(tD, ctx, pd, deriv);
+                double ms = elapsedMs(start);
+                std::printf("  %-10s %5d %8d %14.2e %14.2e %10.2f\n", ModelInversion::methodName(methods[m]), orders[m], ppd,
+                            maxRelativeDiff(deriv, refDeriv, DerivativeFloor),
+                            maxRelativeDiff(logDifference(tD, pd), refDeriv, DerivativeFloor), ms);
+            }
+        }
+    }
+    return 0;
+}
+
+// ---------------- grid ----------------
+int benchGrid(int argc, char** argv)
+{
+    int count = argc > 0 ? std::atoi(argv[0]) : 20000;
+    int nf = argc > 1 ? std::atoi(argv[1]) : 4;
+    const double tolerances[] = { 1e-3, 1e-4, 1e-5 };
+
+    // 模拟高频采集: 均匀时间采样 (线性间隔，晚期点极密)
+    std::vector<double> tD(count);
+    for (int i = 0; i < count; ++i) tD[i] = 1e-3 + (1e4 - 1e-3) * (i + 1.0) / count;
+
+    int failures = 0;
+    std::printf("grid benchmark: %d linearly sampled points, tD = 1e-3 .. 1e4, nf = %d, Stehfest N=8\n", count, nf);
+    std::printf("  %-6s %10s %9s %7s %6s %12s %12s %12s\n", "model", "tol", "time ms", "nodes", "rounds",
+                "est err", "pD err", "deriv err");
+    for (int t = ModelKernel::Model_1; t <= ModelKernel::Model_6; ++t) {
+        ModelContext ctx = benchContext((ModelKernel::ModelType)t, nf);
+        ctx.stehfestN = 8;
+        std::vector<double> pd, deriv;
+        auto start = std::chrono::steady_clock::now();
+        ModelKernel::calculatePDAndDerivative(tD, ctx, pd, deriv);
+        std::printf("  Model_%d %8s %9.1f %7d %6s %12s %12s %12s\n", t + 1, "direct", elapsedMs(start), count, "-", "-", "-", "-");
+
+        for (double tol : tolerances) {
+            std::vector<double> gp, gd;
+            CurveGridReport report;
+            start = std::chrono::steady_clock::now();
+            ModelCurveGrid::evaluate(tD, ctx, tol, gp, gd, &report);
+            double ms = elapsedMs(start);
+            double pdErr = maxRelativeDiff(gp, pd), derivErr = maxRelativeDiff(gd, deriv, 1e-6);
+            bool failed = !(pdErr <= tol && derivErr <= tol);
+            if (failed) ++failures;
+            std::printf("  %-6s %10.0e %9.1f %7d %6d %12.2e %12.2e %12.2e%s%s\n", "", tol, ms, report.nodeCount,
+                        report.refinementRounds, report.maxErrorEstimate, pdErr, derivErr,
+                        report.direct ? "  (direct)" : "", failed ? "  FAIL" : "");
+        }
+    }
+    std::printf("%s\n", failures ? "FAILED: interpolated curve exceeds the tolerance" : "OK");
+    return failures ? 1 : 0;
+}
+
+// ---------------- master ----------------
+int benchMaster(int argc, char** argv)
+{
+    int count = argc > 0 ? std::atoi(argv[0]) : 300;
+    int nf = argc > 1 ? std::atoi(argv[1]) : 4;
+    const double tol = 1e-4;
+    // phi、mu、Ct 在对数域 ±0.01 扰动使 tD 平移 ∓0.01 个对数周期，q、B、h 不改变 tD；
+    // 最后两组对应 LM 试探步中较大的比例参数变化
+    const double shifts[] = { 0.01, -0.01, 0.01, -0.01, 0.01, -0.01, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.3, -0.3 };
+    const int shiftCount = sizeof(shifts) / sizeof(shifts[0]);
+    std::vector<double> tD = logTimes(count, -2.0, 3.0);
+
+    std::printf("master benchmark: %d observation points, tD = 1e-2 .. 1e3, nf = %d, Stehfest N=8, tol %.0e\n", count, nf, tol);
+    std::printf("  %d scaled evaluations (6 scaling parameters x 2 + 2 trial steps)\n", shiftCount);
+    std::printf("  %-7s %10s %10s %10s %6s %6s %12s %12s\n", "model", "full ms", "build ms", "cached ms", "hits", "direct", "pD err", "deriv err");
+    int failures = 0;
+    for (int t = ModelKernel::Model_1; t <= ModelKernel::Model_6; ++t) {
+        ModelContext ctx = benchContext((ModelKernel::ModelType)t, nf);
+        ctx.stehfestN = 8;
+
+        std::vector<std::vector<double>> scaled(shiftCount, tD);
+        for (int k = 0; k < shiftCount; ++k) {
+            for (double& v : scaled[k]) v *= std::pow(10.0, shifts[k]);
+        }
+
+        // 原做法: 每次扰动完整计算
+        std::vector<std::vector<double>> refPD(shiftCount), refDeriv(shiftCount);
+        auto start = std::chrono::steady_clock::now();
+        for (int k = 0; k < shiftCount; ++k) ModelKernel::calculatePDAndDerivative(scaled[k], ctx, refPD[k], refDeriv[k]);
+        double fullMs = elapsedMs(start);
+
+        // 主曲线: 基点计算一次，其余扰动全部平移插值
+        ModelCurveGrid::clearMasterCache();
+        start = std::chrono::steady_clock::now();
+        ModelCurveGrid::masterCurve(tD, ctx, tol);
+        double buildMs = elapsedMs(start);
+
+        // 与 ModelSolver::computeCurve 相同: 没有可用的主曲线时逐点计算
+        int hits = 0, direct = 0;
+        double pdErr = 0.0, derivErr = 0.0;
+        std::vector<double> pd, deriv;
+        start = std::chrono::steady_clock::now();
+        for (int k = 0; k < shiftCount; ++k) {
+            CurveGridReport report;
+            std::shared_ptr<const MasterCurve> master = ModelCurveGrid::masterCurve(scaled[k], ctx, tol, &report);
+            if (master) {
+                master->evaluate(scaled[k], pd, deriv);
+            } else {
+                ModelKernel::calculatePDAndDerivative(scaled[k], ctx, pd, deriv);
+                ++direct;
+            }
+            if (report.cached) ++hits;
+            pdErr = std::max(pdErr, maxRelativeDiff(pd, refPD[k]));
+            derivErr = std::max(derivErr, maxRelativeDiff(deriv, refDeriv[k], 1e-6));
+        }
+        double cachedMs = elapsedMs(start);
+        bool failed = !(pdErr <= tol && derivErr <= tol);
+        if (failed) ++failures;
+        std::printf("  Model_%d %10.1f %10.1f %10.2f %3d/%-2d %6d %12.2e %12.2e%s\n", t + 1, fullMs, buildMs, cachedMs,
+                    hits, shiftCount, direct, pdErr, derivErr, failed ? "  FAIL" : "");
+    }
+    std::printf("%s\n", failures ? "FAILED: master curve exceeds the tolerance" : "OK");
+    return failures ? 1 : 0;
+}
+
+// ---------------- response ----------------
+int benchResponse(int argc, char** argv)
+{
+    int count = argc > 0 ? std::atoi(argv[0]) : 300;
+    int nf = argc > 1 ? std::atoi(argv[1]) : 4;
+    std::vector<double> tD = logTimes(count, -2.0, 3.0);
+    struct Method { ModelInversion::Method method; int order; };
+    const Method methods[] = { { ModelInversion::Stehfest, 8 }, { ModelInversion::Talbot, 12 } };
+
+    // 基点 + cD、S、gamaD 各正负扰动一次 (对数域 ±0.01 或线性 ±1e-4，与 computeJacobian 一致)
+    auto perturbed = [](const ModelContext& base, int k) {
+        ModelContext c = base;
+        double f = (k % 2 == 1) ? std::pow(10.0, 0.01) : std::pow(10.0, -0.01);
+        if (k == 1 || k == 2) c.cD *= f;
+        if (k == 3 || k == 4) c.S += (k == 3) ? 1e-4 : -1e-4;
+        if (k == 5 || k == 6) c.gamaD *= f;
+        return c;
+    };
+    const int evaluations = 7;
+
+    std::printf("response benchmark: %d points, tD = 1e-2 .. 1e3, nf = %d, base + cD/S/gamaD +/- (%d curves)\n",
+                count, nf, evaluations);
+    std::printf("  %-7s %-9s %12s %12s %8s %12s %10s\n", "model", "method", "no cache ms", "cache ms", "speedup",
+                "max diff", "hit rate");
+    for (int t : { ModelKernel::Model_1, ModelKernel::Model_3, ModelKernel::Model_5 }) {
+        for (const Method& m : methods) {
+            ModelContext base = benchContext((ModelKernel::ModelType)t, nf);
+            base.inversionMethod = m.method;
+            base.stehfestN = 8;
+            base.inversionOrder = m.order;
+
+            std::vector<std::vector<double>> ref(evaluations), refDeriv(evaluations);
+            auto start = std::chrono::steady_clock::now();
+            for (int k = 0; k < evaluations; ++k) {
+                ModelKernel::calculatePDAndDerivative(tD, perturbed(base, k), ref[k], refDeriv[k]);
+            }
+            double plainMs = elapsedMs(start);
+
+            ModelResponseCache::clear();
+            ModelResponseCache::resetStats();
+            base.cacheResponse = true;
+            double diff = 0.0;
+            std::vector<double> pd, deriv;
+            start = std::chrono::steady_clock::now();
+            for (int k = 0; k < evaluations; ++k) {
+                ModelKernel::calculatePDAndDerivative(tD, perturbed(base, k), pd, deriv);
+                for (int i = 0; i < count; ++i) {
+                    diff = std::max(diff, std::max(std::abs(pd[i] - ref[k][i]), std::abs(deriv[i] - refDeriv[k][i])));
+                }
+            }
+            double cachedMs = elapsedMs(start);
+            ModelResponseCache::Stats stats = ModelResponseCache::stats();
+            std::printf("  Model_%d %-9s %12.1f %12.1f %7.1fx %12.1e %9.1f%%\n", t + 1, ModelInversion::methodName(m.method),
+                        plainMs, cachedMs, plainMs / cachedMs, diff,
+                        100.0 * stats.hits / std::max(1LL, stats.hits + stats.misses));
+        }
+    }
+    return 0;
+}
+
+// ---------------- laplace ----------------
+int benchLaplace(int argc, char** argv)
+{
+    int nf = argc > 0 ? std::atoi(argv[0]) : 4;
+    double minMs = argc > 1 ? std::atof(argv[1]) : 300.0;
+    std::vector<double> tD = logTimes(40, -3.0, 4.0);
+
+    // Stehfest (N=8) 与 Talbot (M=12) 在这些时间点上的全部节点
+    std::vector<double> realNodes;
+    std::vector<std::complex<double>> complexNodes;
+    for (double t : tD) {
+        std::complex<double> s[12];
+        ModelInversion::nodes(ModelInversion::Stehfest, 8, t, s);
+        for (int k = 0; k < 8; ++k) realNodes.push_back(s[k].real());
+        ModelInversion::nodes(ModelInversion::Talbot, 12, t, s);
+        for (int k = 0; k < 12; ++k) complexNodes.push_back(s[k]);
+    }
+
+    // 整组节点重复计算，分 5 轮各不少于 minMs/5，取最快一轮的每次计算平均耗时 (微秒)，减小机器负载的干扰。
+    // checksum 只累加第一遍的结果，用于核对不同实现的计算结果是否一致
+    auto timeNodes = [&](auto& nodes, const ModelContext& ctx, double& checksum) {
+        double best = HUGE_VAL, sink = 0.0;
+        bool first = true;
+        for (int round = 0; round < 5; ++round) {
+            long long evaluations = 0;
+            auto start = std::chrono::steady_clock::now();
+            do {
+                double sum = 0.0;
+                for (const auto& z : nodes) sum += std::abs(ModelKernel::flaplace_composite(z, ctx));
+                if (first) { checksum += sum; first = false; }
+                sink += sum;
+                evaluations += (long long)nodes.size();
+            } while (elapsedMs(start) < minMs / 5);
+            best = std::min(best, elapsedMs(start) * 1e3 / evaluations);
+        }
+        return sink != 0.0 ? best : 0.0;
+    };
+
+    std::printf("laplace benchmark: flaplace_composite per evaluation, nf = %d\n", nf);
+    std::printf("  %-7s %14s %14s\n", "model", "real us", "complex us");
+    double checksum = 0.0;
+    for (int t = ModelKernel::Model_1; t <= ModelKernel::Model_6; ++t) {
+        ModelContext ctx = benchContext((ModelKernel::ModelType)t, nf);
+        double realUs = timeNodes(realNodes, ctx, checksum);
+        double complexUs = timeNodes(complexNodes, ctx, checksum);
+        std::printf("  Model_%d %14.2f %14.2f\n", t + 1, realUs, complexUs);
+    }
+    std::printf("  (checksum %.15e)\n", checksum);
+    return 0;
+}
+
+// ---------------- alloc ----------------
+int benchAlloc(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+    const int fractureCounts[] = { 1, 4, 8, 16, ModelKernel::MaxStackFractures + 1, 32 };
+    const int calls = 50;
+    const std::complex<double> zc(3.0, 4.0);
+
+    std::printf("alloc benchmark: heap allocations per flaplace_composite call (stack bound nf <= %d)\n",
+                ModelKernel::MaxStackFractures);
+    std::printf("  %-4s %-7s %12s %12s\n", "nf", "model", "real", "complex");
+    int failures = 0;
+    for (int nf : fractureCounts) {
+        for (int t = ModelKernel::Model_1; t <= ModelKernel::Model_6; ++t) {
+            ModelContext ctx = benchContext((ModelKernel::ModelType)t, nf);
+            // 预热: 积分节点表等一次性初始化不计入
+            ModelKernel::flaplace_composite(0.5, ctx);
+            ModelKernel::flaplace_composite(zc, ctx);
+
+            long long before = g_allocations.load();
+            for (int k = 0; k < calls; ++k) ModelKernel::flaplace_composite(0.5 * (k + 1), ctx);
+            double realAllocs = double(g_allocations.load() - before) / calls;
+            before = g_allocations.load();
+            for (int k = 0; k < calls; ++k) ModelKernel::flaplace_composite(zc * double(k + 1), ctx);
+            double complexAllocs = double(g_allocations.load() - before) / calls;
+
+            bool expectZero = nf <= ModelKernel::MaxStackFractures;
+            bool failed = expectZero && (realAllocs != 0.0 || complexAllocs != 0.0);
+            if (failed) ++failures;
+            std::printf("  %-4d Model_%d %12.2f %12.2f%s\n", nf, t + 1, realAllocs, complexAllocs, failed ? "  FAIL" : "");
+        }
+    }
+    std::printf("%s\n", failures ? "FAILED: allocations on the stack-only path" : "OK: no allocations for nf within the stack bound");
+    return failures ? 1 : 0;
+}
+
+// ---------------- scaling ----------------
+int benchScaling(int argc, char** argv)
+{
+    int model = argc > 0 ? std::atoi(argv[0]) : 2;
+    int maxNf = argc > 1 ? std::atoi(argv[1]) : 256;
+    double minMs = argc > 2 ? std::atof(argv[2]) : 200.0;
+    ModelKernel::ModelType type = (ModelKernel::ModelType)std::max(0, std::min(5, model - 1));
+    std::vector<double> tD = logTimes(5, -2.0, 3.0);
+
+    std::vector<double> realNodes;
+    std::vector<std::complex<double>> complexNodes;
+    for (double t : tD) {
+        std::complex<double> s[12];
+        ModelInversion::nodes(ModelInversion::Stehfest, 8, t, s);
+        for (int k = 0; k < 8; ++k) realNodes.push_back(s[k].real());
+        ModelInversion::nodes(ModelInversion::Talbot, 12, t, s);
+        for (int k = 0; k < 12; ++k) complexNodes.push_back(s[k]);
+    }
+
+    // 整组节点重复计算不少于 minMs，返回每次计算平均耗时 (微秒)，values 为第一遍的结果
+    auto timeNodes = [&](const auto& nodes, const ModelContext& ctx, std::vector<double>& values) {
+        values.clear();
+        long long evaluations = 0;
+        auto start = std::chrono::steady_clock::now();
+        do {
+            for (const auto& z : nodes) {
+                double v = std::abs(ModelKernel::flaplace_composite(z, ctx));
+                if (evaluations < (long long)nodes.size()) values.push_back(v);
+                ++evaluations;
+            }
+        } while (elapsedMs(start) < minMs);
+        return elapsedMs(start) * 1e3 / evaluations;
+    };
+
+    struct Variant { const char* name; ModelKernel::FractureSolver solver; bool compress; };
+    const Variant variants[] = {
+        { "direct", ModelKernel::DirectFractureSolver, false },
+        { "iterative", ModelKernel::IterativeFractureSolver, false },
+        { "iter+far", ModelKernel::IterativeFractureSolver, true },
+    };
+
+    std::printf("scaling benchmark: Model_%d, us per flaplace_composite (Stehfest 8 real / Talbot 12 complex nodes)\n",
+                type + 1);
+    std::printf("  %-4s %-10s %12s %12s %12s %12s\n", "nf", "solver", "real us", "complex us", "real diff", "cplx diff");
+    for (int nf = 4; nf <= maxNf; nf *= 2) {
+        std::vector<double> refReal, refComplex;
+        for (const Variant& v : variants) {
+            ModelContext ctx = benchContext(type, nf);
+            ctx.fractureSolver = v.solver;
+            ctx.compressFarField = v.compress;
+            std::vector<double> realValues, complexValues;
+            double realUs = timeNodes(realNodes, ctx, realValues);
+            double complexUs = timeNodes(complexNodes, ctx, complexValues);
+            if (v.solver == ModelKernel::DirectFractureSolver) { refReal = realValues; refComplex = complexValues; }
+            std::printf("  %-4d %-10s %12.1f %12.1f %12.1e %12.1e\n", nf, v.name, realUs, complexUs,
+                        maxRelativeDiff(realValues, refReal), maxRelativeDiff(complexValues, refComplex));
+        }
+    }
+    return 0;
+}
+
+// ---------------- cache ----------------
+int benchCache(int argc, char** argv)
+{
+    int sets = argc > 0 ? std::atoi(argv[0]) : 6;
+    const std::vector<double> tD = logTimes(100, -3.0, 4.0);
+    const double limitsMB[] = { 0.25, 1.0, 64.0 };
+
+    std::printf("cache benchmark: %d parameter sets x 3 rounds, Model_1, Stehfest N=8, %d time points\n",
+                sets, (int)tD.size());
+    std::printf("  %-10s %10s %10s %10s %12s %10s %12s\n", "limit", "hits", "misses", "evictions", "peak bytes",
+                "repeat", "ms");
+    int failures = 0;
+    for (double mb : limitsMB) {
+        size_t limit = (size_t)(mb * (1 << 20));
+        ModelResponseCache::clear();
+        ModelResponseCache::setMemoryLimit(limit);
+        ModelResponseCache::resetStats();
+        size_t peak = 0;
+        std::vector<double> pd, deriv;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < 3; ++round) {
+            for (int k = 0; k < sets; ++k) {
+                ModelContext ctx = benchContext(ModelKernel::Model_1, 4);
+                ctx.stehfestN = 8;
+                ctx.cacheResponse = true;
+                ctx.kf *= 1.0 + 0.1 * k;
+                ModelKernel::calculatePDAndDerivative(tD, ctx, pd, deriv);
+                peak = std::max(peak, ModelResponseCache::stats().memoryBytes);
+            }
+        }
+        double ms = elapsedMs(start);
+        ModelResponseCache::Stats stats = ModelResponseCache::stats();
+
+        // 参数不变的重复计算 (界面重复刷新): 最近一组参数应全部命中
+        ModelContext ctx = benchContext(ModelKernel::Model_1, 4);
+        ctx.stehfestN = 8;
+        ctx.cacheResponse = true;
+        ctx.kf *= 1.0 + 0.1 * (sets - 1);
+        ModelResponseCache::resetStats();
+        ModelKernel::calculatePDAndDerivative(tD, ctx, pd, deriv);
+        ModelResponseCache::Stats repeat = ModelResponseCache::stats();
+
+        bool failed = peak > limit || repeat.misses != 0;
+        if (failed) ++failures;
+        std::printf("  %7.2f MB %10lld %10lld %10lld %12zu %4lld/%-5lld %12.1f%s\n", mb, stats.hits, stats.misses,
+                    stats.evictions, peak, repeat.hits, repeat.hits + repeat.misses, ms, failed ? "  FAIL" : "");
+    }
+    ModelResponseCache::setMemoryLimit(ModelResponseCache::DefaultMemoryLimit);
+    std::printf("%s\n", failures ? "FAILED: cache exceeded its limit or missed on a repeat" : "OK");
+    return failures ? 1 : 0;
+}
+
+// ---------------- aligned ----------------
+int benchAligned(int argc, char** argv)
+{
+    int points = argc > 0 ? std::atoi(argv[0]) : 100;
+    int N = argc > 1 ? std::atoi(argv[1]) : 8;
+    struct Grid { const char* name; std::vector<double> t; };
+    const Grid grids[] = {
+        { "log", logTimes(points, -3.0, 3.0) },
+        { "aligned", ModelInversion::alignedTimes(points, -3.0, 3.0) },
+    };
+    const ModelKernel::ModelType types[] = { ModelKernel::Model_1, ModelKernel::Model_4 };
+    int failures = 0;
+    if (grids[1].t.size() != grids[0].t.size() || grids[1].t.front() != grids[0].t.front()
+        || grids[1].t.back() != grids[0].t.back()) {
+        ++failures;
+    }
+
+    std::printf("aligned benchmark: Stehfest N=%d, tD = 1e-3 .. 1e3, nf = 4\n", N);
+    std::printf("  %-7s %-8s %7s %9s %9s %7s %9s %12s\n", "model", "grid", "points", "nodes", "laplace", "ratio",
+                "ms", "diff");
+    for (ModelKernel::ModelType type : types) {
+        ModelContext ctx = benchContext(type, 4);
+        ctx.stehfestN = N;
+        for (const Grid& g : grids) {
+            std::vector<double> pd, deriv;
+            InversionReport report;
+            double best = HUGE_VAL;
+            for (int round = 0; round < 3; ++round) {
+                auto start = std::chrono::steady_clock::now();
+                ModelKernel::calculatePDAndDerivative(g.t, ctx, pd, deriv, &report);
+                best = std::min(best, elapsedMs(start));
+            }
+            // 逐点单独计算 (没有可共享的节点) 作为参照
+            double diff = 0.0;
+            std::vector<double> one(1), p1, d1;
+            for (size_t i = 0; i < g.t.size(); ++i) {
+                one[0] = g.t[i];
+                ModelKernel::calculatePDAndDerivative(one, ctx, p1, d1);
+                diff = std::max(diff, std::max(std::abs(p1[0] - pd[i]), std::abs(d1[0] - deriv[i])));
+            }
+            if (diff != 0.0) ++failures;
+            std::printf("  Model_%d %-8s %7d %9lld %9lld %6.1f%% %9.2f %12.1e%s\n", type + 1, g.name, (int)g.t.size(),
+                        report.evaluations, report.laplaceEvaluations,
+                        100.0 * report.laplaceEvaluations / std::max(1LL, report.evaluations), best, diff,
+                        diff != 0.0 ? "  FAIL" : "");
+        }
+
+        // 插值到任意时间: 主曲线构造时实际计算的储层响应个数 (各轮之间经储层响应缓存复用)
+        ModelCurveGrid::clearMasterCache();
+        ModelResponseCache::clear();
+        ModelResponseCache::resetStats();
+        ctx.cacheResponse = true;
+        CurveGridReport gridReport;
+        ModelCurveGrid::masterCurve(logTimes(300, -2.0, 3.0), ctx, 1e-4, &gridReport);
+        ModelResponseCache::Stats stats = ModelResponseCache::stats();
+        long long naive = (long long)gridReport.nodeCount * N;
+        std::printf("  Model_%d %-8s %7d %9lld %9lld %6.1f%%\n", type + 1, "master", gridReport.nodeCount, naive,
+                    stats.misses, 100.0 * stats.misses / std::max(1LL, naive));
+    }
+    std::printf("%s\n", failures ? "FAILED: aligned grid differs in size or endpoints, or from per-point results" : "OK");
+    return failures ? 1 : 0;
+}
+
+// ---------------- batch ----------------
+int benchBatch(int argc, char** argv)
+{
+    int nf = argc > 0 ? std::atoi(argv[0]) : 4;
+    int threads = argc > 1 ? std::atoi(argv[1]) : 1;
+    std::vector<double> tD = logTimes(40, -3.0, 4.0);
+    std::vector<double> realNodes;
+    std::vector<std::complex<double>> complexNodes;
+    for (double t : tD) {
+        std::complex<double> s[12];
+        ModelInversion::nodes(ModelInversion::Stehfest, 8, t, s);
+        for (int k = 0; k < 8; ++k) realNodes.push_back(s[k].real());
+        ModelInversion::nodes(ModelInversion::Talbot, 12, t, s);
+        for (int k = 0; k < 12; ++k) complexNodes.push_back(s[k]);
+    }
+
+    // 最快一轮的每点耗时 (微秒)
+    auto bestUs = [](int rounds, int perRound, auto&& body) {
+        double best = HUGE_VAL;
+        for (int r = 0; r < rounds; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            body();
+            best = std::min(best, elapsedMs(start) * 1e3 / perRound);
+        }
+        return best;
+    };
+
+    std::printf("batch benchmark: nf = %d, threads = %d, %d real / %d complex nodes\n", nf, threads,
+                (int)realNodes.size(), (int)complexNodes.size());
+    std::printf("  %-7s %12s %12s %12s %12s %10s\n", "model", "real us", "real batch", "cplx us", "cplx batch", "diff");
+    for (int t = ModelKernel::Model_1; t <= ModelKernel::Model_6; ++t) {
+        ModelContext ctx = benchContext((ModelKernel::ModelType)t, nf);
+        ctx.threadCount = threads;
+        std::vector<double> r1(realNodes.size()), r2(realNodes.size());
+        std::vector<std::complex<double>> c1(complexNodes.size()), c2(complexNodes.size());
+        int nr = (int)realNodes.size(), nc = (int)complexNodes.size();
+        double realUs = bestUs(5, nr, [&] { for (int i = 0; i < nr; ++i) r1[i] = ModelKernel::flaplace_composite(realNodes[i], ctx); });
+        double realBatch = bestUs(5, nr, [&] { ModelKernel::flaplace_composite(realNodes.data(), nr, ctx, r2.data()); });
+        double cplxUs = bestUs(3, nc, [&] { for (int i = 0; i < nc; ++i) c1[i] = ModelKernel::flaplace_composite(complexNodes[i], ctx); });
+        double cplxBatch = bestUs(3, nc, [&] { ModelKernel::flaplace_composite(complexNodes.data(), nc, ctx, c2.data()); });
+        double diff = 0.0;
+        for (int i = 0; i < nr; ++i) diff = std::max(diff, std::abs(r1[i] - r2[i]));
+        for (int i = 0; i < nc; ++i) diff = std::max(diff, std::abs(c1[i] - c2[i]));
+        std::printf("  Model_%d %12.2f %12.2f %12.2f %12.2f %10.1e\n", t + 1, realUs, realBatch, cplxUs, cplxBatch, diff);
+    }
+    return 0;
+}
+
+// ---------------- sweep ----------------
+int benchSweep(int argc, char** argv)
+{
+    int threads = argc > 0 ? std::atoi(argv[0]) : 0;
+    const char* path = argc > 1 ? argv[1] : "modelbench_sweep.bin";
+
+    ModelSweep::Plan plan;
+    plan.type = ModelKernel::Model_1;
+    plan.base.set(ModelParams::Kf, 1e-3);
+    plan.base.set(ModelParams::Km, 1e-4);
+    plan.base.set(ModelParams::LfD, 0.1);
+    plan.base.set(ModelParams::Nf, 4);
+    plan.base.set(ModelParams::RmD, 4.0);
+    plan.base.set(ModelParams::Omega1, 0.4);
+    plan.base.set(ModelParams::Omega2, 0.08);
+    plan.base.set(ModelParams::Lambda1, 1e-3);
+    plan.base.set(ModelParams::GamaD, 0.02);
+    plan.time = logTimes(60, -3.0, 3.0);
+
+    auto axis = [](ModelParams::Id id, double lo, double hi, int count, bool logScale) {
+        ModelSweep::Axis a;
+        a.id = id;
+        a.min = lo;
+        a.max = hi;
+        a.count = count;
+        a.logScale = logScale;
+        return a;
+    };
+    plan.axes = { axis(ModelParams::Kf, 1e-4, 1e-2, 4, true), axis(ModelParams::Nf, 2, 6, 3, false),
+                  axis(ModelParams::CD, 1e-3, 1e-1, 5, true), axis(ModelParams::S, 0.0, 4.0, 5, false) };
+
+    // 无因次曲线: 上下文直接由参数块构造 (界面中由 ModelSolver 完成有因次换算)
+    bool cached = false;
+    ModelSweep::CurveFunction curve = [&](const ModelParams& p, std::vector<double>& pd, std::vector<double>& dd) {
+        ModelContext ctx = benchContext(plan.type, (int)p.value(ModelParams::Nf));
+        ctx.kf = p.value(ModelParams::Kf);
+        ctx.cD = p.value(ModelParams::CD);
+        ctx.S = p.value(ModelParams::S);
+        ctx.stehfestN = 8;
+        ctx.cacheResponse = cached;
+        ModelKernel::calculatePDAndDerivative(plan.time, ctx, pd, dd);
+        return true;
+    };
+
+    std::printf("sweep benchmark: Model_1, kf x nf x cD x S, %d time points, threads = %d\n", (int)plan.time.size(),
+                ModelThreadPool::resolveThreadCount(threads));
+    std::printf("  %-10s %7s %7s %10s %10s %9s %10s %12s\n", "sampling", "cases", "groups", "serial ms", "sweep ms",
+                "speedup", "file KB", "diff");
+    int failures = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        plan.sampling = pass == 0 ? ModelSweep::Cartesian : ModelSweep::LatinHypercube;
+        plan.sampleCount = 200;
+        std::vector<double> cases = ModelSweep::generateCases(plan);
+        const long long n = ModelSweep::caseCount(plan);
+        const int a = (int)plan.axes.size();
+
+        // 参照: 逐条串行计算，不使用缓存
+        cached = false;
+        std::vector<std::vector<double>> reference((size_t)n);
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < n; ++i) {
+            std::vector<double> dd;
+            curve(ModelSweep::caseParams(plan, cases.data() + (size_t)i * a), reference[(size_t)i], dd);
+        }
+        double serialMs = elapsedMs(start);
+
+        cached = true;
+        ModelResponseCache::clear();
+        ModelSweep::Options options;
+        options.outputPath = path;
+        options.threadCount = threads;
+        start = std::chrono::steady_clock::now();
+        ModelSweep::Result result = ModelSweep::run(plan, curve, options);
+        double sweepMs = elapsedMs(start);
+
+        // 回读结果文件，与逐条计算比较 (文件中为 float)
+        ModelSweepFile file;
+        double diff = 0.0;
+        if (!file.open(path) || file.caseCount() != n) {
+            diff = HUGE_VAL;
+        } else {
+            std::vector<double> values, pd;
+            for (long long i = 0; i < n; ++i) {
+                file.readCase(i, &values, &pd);
+                for (int j = 0; j < a; ++j) {
+                    diff = std::max(diff, values[j] == cases[(size_t)i * a + j] ? 0.0 : 1.0);
+                    if (ModelParams::isInteger(plan.axes[j].id) && values[j] != std::round(values[j])) diff = 1.0;
+                }
+                diff = std::max(diff, maxRelativeDiff(pd, reference[(size_t)i]));
+            }
+        }
+        if (result.ioError || result.completed != n || result.failed != 0 || !(diff < 1e-6)) ++failures;
+        long long fileBytes = (long long)(ModelSweepFile::headerSize(a, (int)plan.time.size())
+                                          + n * ModelSweepFile::recordSize(a, (int)plan.time.size()));
+        std::printf("  %-10s %7lld %7lld %10.1f %10.1f %8.2fx %10.1f %12.1e\n",
+                    pass == 0 ? "cartesian" : "lhs", n, result.groups, serialMs, sweepMs, serialMs / sweepMs,
+                    fileBytes / 1024.0, diff);
+    }
+    std::remove(path);
+    std::printf("%s\n", failures ? "FAILED: sweep records differ from serial curves" : "OK");
+    return failures ? 1 : 0;
+}
+
+// 拟合基准共用的无因次问题: log10 kf, km, omega1, lambda1, cD 与线性 S，
+// 观测数据为真值曲线叠加固定种子的对数均匀噪声 (±noise，log10 单位)
+struct FitBenchProblem
+{
+    int points = 0;
+    int stehfestN = 8;
+    std::vector<double> t, obsP, obsD;
+    Eigen::VectorXd truth, start;
+    std::atomic<long long> calls{0};
+    ModelFitter::Problem problem;
+};
+
+ModelContext fitBenchContext(const Eigen::VectorXd& u, int stehfestN = 8)
+{
+    ModelContext ctx = benchContext(ModelKernel::Model_1, 4);
+    ctx.kf = std::pow(10.0, u[0]);
+    ctx.km = std::pow(10.0, u[1]);
+    ctx.omega1 = std::pow(10.0, u[2]);
+    ctx.lambda1 = std::pow(10.0, u[3]);
+    ctx.cD = std::pow(10.0, u[4]);
+    ctx.S = u[5];
+    ctx.stehfestN = stehfestN;
+    return ctx;
+}
+
+// stehfestN: 拟合计算使用的 Stehfest 项数 (观测数据始终由 N = 8 生成)
+void setupFitBench(FitBenchProblem& b, int points, double noise, int stehfestN = 8)
+{
+    b.points = points;
+    b.stehfestN = stehfestN;
+    b.t = logTimes(points, -2.0, 4.0);
+    b.truth.resize(6);
+    b.start.resize(6);
+    b.truth << -3.0, -4.0, std::log10(0.4), -3.0, -2.0, 1.0;
+    b.start << -2.4, -4.5, std::log10(0.2), -2.3, -1.5, 2.5;
+
+    ModelKernel::calculatePDAndDerivative(b.t, fitBenchContext(b.truth), b.obsP, b.obsD);
+    unsigned int seed = 12345u;
+    auto uniform = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / double(1u << 24) * 2.0 - 1.0;
+    };
+    for (int i = 0; i < points; ++i) {
+        b.obsP[i] *= std::pow(10.0, noise * uniform());
+        b.obsD[i] *= std::pow(10.0, noise * uniform());
+    }
+
+    FitBenchProblem* pb = &b;
+    b.problem.residuals = [pb](const Eigen::VectorXd& u, Eigen::VectorXd& r) {
+        ++pb->calls;
+        std::vector<double> pd, dd;
+        ModelKernel::calculatePDAndDerivative(pb->t, fitBenchContext(u, pb->stehfestN), pd, dd);
+        const int n = pb->points;
+        r.resize(2 * n);
+        for (int i = 0; i < n; ++i) {
+            r[i] = std::log10(std::max(pd[i], 1e-12)) - std::log10(std::max(pb->obsP[i], 1e-12));
+            r[n + i] = std::log10(std::max(dd[i], 1e-12)) - std::log10(std::max(pb->obsD[i], 1e-12));
+        }
+        return r.allFinite();
+    };
+    b.problem.lower = Eigen::VectorXd::Constant(6, -8.0);
+    b.problem.upper = Eigen::VectorXd::Constant(6, 2.0);
+    b.problem.lower[2] = -3.0;
+    b.problem.upper[2] = 0.0;
+    b.problem.lower[5] = 0.0;
+    b.problem.upper[5] = 20.0;
+    b.problem.steps = Eigen::VectorXd::Constant(6, 0.01);
+    b.problem.steps[5] = 1e-4;
+}
+
+int benchFit(int argc, char** argv)
+{
+    int points = argc > 0 ? std::atoi(argv[0]) : 60;
+    int maxIterations = argc > 1 ? std::atoi(argv[1]) : 50;
+    double noise = argc > 2 ? std::atof(argv[2]) : 0.01;
+    double startScale = argc > 3 ? std::atof(argv[3]) : 0.25;
+
+    FitBenchProblem bench;
+    setupFitBench(bench, points, noise);
+    const ModelFitter::Problem& problem = bench.problem;
+    // 该问题参数不完全可辨识: 离真值较远时，迭代路径不同的设置 (Broyden 等) 会停在另外的局部极小值
+    const Eigen::VectorXd start = bench.truth + startScale * (bench.start - bench.truth);
+    std::atomic<long long>& calls = bench.calls;
+
+    std::printf("fit benchmark: Model_1, 6 parameters, %d time points, noise %.3g, max %d iterations, start %.2g\n",
+                points, noise, maxIterations, startScale);
+    std::printf("  %-24s %5s %6s %7s %7s %9s %12s  %s\n", "method", "iter", "evals", "builds", "broyden", "ms",
+                "final MSE", "stop");
+    struct Setting
+    {
+        const char* name;
+        ModelFitter::DampingUpdate damping;
+        bool stoppingTests;
+        bool geodesic;
+        bool broyden;
+        ModelFitter::JacobianMode mode;
+    };
+    // 第一行为原有迭代方式: ×10/÷10 阻尼，只按误差目标与 λ 上限停止
+    const Setting settings[] = {
+        { "marquardt (legacy)", ModelFitter::MarquardtDamping, false, false, false, ModelFitter::CentralDifference },
+        { "marquardt + tests", ModelFitter::MarquardtDamping, true, false, false, ModelFitter::CentralDifference },
+        { "nielsen", ModelFitter::NielsenDamping, true, false, false, ModelFitter::CentralDifference },
+        { "nielsen + geodesic", ModelFitter::NielsenDamping, true, true, false, ModelFitter::CentralDifference },
+        { "nielsen + broyden", ModelFitter::NielsenDamping, true, false, true, ModelFitter::CentralDifference },
+        { "nielsen + broyden + fwd", ModelFitter::NielsenDamping, true, false, true, ModelFitter::ForwardDifference },
+    };
+    double baseMs = 0.0, baseMSE = 0.0;
+    int failures = 0;
+    bool first = true;
+    for (const Setting& setting : settings) {
+        ModelFitter::Options options;
+        options.maxIterations = maxIterations;
+        options.targetMSE = noise > 0.0 ? 0.0 : 1e-10;
+        options.damping = setting.damping;
+        options.geodesic = setting.geodesic;
+        options.broyden = setting.broyden;
+        options.jacobian = setting.mode;
+        if (!setting.stoppingTests) {
+            options.gradientTolerance = 0.0;
+            options.stepTolerance = 0.0;
+            options.reductionTolerance = 0.0;
+        }
+        calls = 0;
+        auto begin = std::chrono::steady_clock::now();
+        ModelFitter::Report report = ModelFitter::levenbergMarquardt(start, problem, options);
+        double ms = elapsedMs(begin);
+        double mse = report.sse / std::max(report.residualCount, 1);
+        if (first) {
+            baseMs = ms;
+            baseMSE = mse;
+        }
+        // 计数自检: 报告的计算次数应与实际调用次数一致，诊断记录与迭代次数一致
+        if (report.evaluations != calls || (int)report.history.size() != report.iterations) ++failures;
+        // 各设置应停在与原有迭代方式相同的极小值 (更快但误差更大的结果不算加速)
+        const bool worse = !first && !(mse <= baseMSE * 1.05 + 1e-8);
+        if (worse) ++failures;
+        std::printf("  %-24s %5d %6lld %7d %7d %9.1f %12.4e  %s", setting.name, report.iterations, report.evaluations,
+                    report.jacobianBuilds, report.broydenUpdates, ms, mse, ModelFitter::reasonName(report.reason));
+        if (!first) std::printf(" (%.2fx)", baseMs / ms);
+        std::printf("%s\n", worse ? "  FAIL" : "");
+        first = false;
+    }
+    std::printf("%s\n", failures ? "FAILED: evaluation count mismatch or fit worse than the legacy iteration" : "OK");
+    return failures ? 1 : 0;
+}
+
+int benchMultiStart(int argc, char** argv)
+{
+    int starts = argc > 0 ? std::atoi(argv[0]) : 16;
+    int threads = argc > 1 ? std::atoi(argv[1]) : 0;
+    double noise = argc > 2 ? std::atof(argv[2]) : 0.01;
+
+    FitBenchProblem bench;
+    setupFitBench(bench, 60, noise);
+    // 远离真值的初值: 单起点 LM 停在局部极小值
+    Eigen::VectorXd start(6);
+    start << -1.5, -5.5, std::log10(0.05), -5.0, -0.5, 8.0;
+
+    std::printf("multistart benchmark: Model_1, 6 parameters, noise %.3g, %d starts, threads = %d\n", noise, starts,
+                ModelThreadPool::resolveThreadCount(threads));
+    ModelFitter::Options lm;
+    lm.targetMSE = 0.0;
+
+    bench.calls = 0;
+    auto begin = std::chrono::steady_clock::now();
+    ModelFitter::Report single = ModelFitter::levenbergMarquardt(start, bench.problem, lm);
+    double singleMs = elapsedMs(begin);
+    const int m = std::max(single.residualCount, 1);
+    std::printf("  single start: %lld evals, %.1f ms, MSE %.4e (%s)\n", single.evaluations, singleMs, single.sse / m,
+                ModelFitter::reasonName(single.reason));
+
+    ModelFitter::MultiStartOptions options;
+    options.starts = starts;
+    options.lm = lm;
+    ModelFitter::MultiStartReport reports[2];
+    const int threadCounts[2] = { 1, threads };
+    double ms[2] = { 0.0, 0.0 };
+    for (int pass = 0; pass < 2; ++pass) {
+        options.threadCount = threadCounts[pass];
+        bench.calls = 0;
+        begin = std::chrono::steady_clock::now();
+        reports[pass] = ModelFitter::multiStart(start, bench.problem, options);
+        ms[pass] = elapsedMs(begin);
+        if (reports[pass].evaluations != bench.calls) reports[pass].candidates.clear();
+    }
+    const ModelFitter::MultiStartReport& report = reports[1];
+    std::printf("  multi start:  %lld evals, %.1f ms (1 thread %.1f ms)\n", report.evaluations, ms[1], ms[0]);
+    std::printf("  %4s %5s %6s %6s %7s %12s  %s\n", "rank", "start", "rounds", "iter", "evals", "MSE", "stop");
+    for (size_t i = 0; i < report.candidates.size() && i < 8; ++i) {
+        const ModelFitter::Candidate& c = report.candidates[i];
+        std::printf("  %4d %5d %6d %6d %7lld %12.4e  %s%s\n", (int)i + 1, c.start, c.rounds, c.iterations,
+                    c.evaluations, c.sse / m, ModelFitter::reasonName(c.reason), c.polished ? " (polished)" : "");
+    }
+
+    // 检查: 计数一致、最好的候选不差于单起点、结果与线程数无关
+    int failures = 0;
+    if (report.candidates.empty() || reports[0].candidates.size() != report.candidates.size()) {
+        ++failures;
+    } else {
+        // 分段迭代 (每轮重置 λ) 与连续迭代路径不同，同一极小值附近允许微小差异
+        if (!(report.candidates[0].sse <= single.sse * (1.0 + 1e-3))) ++failures;
+        for (size_t i = 0; i < report.candidates.size(); ++i) {
+            if (reports[0].candidates[i].start != report.candidates[i].start
+                || reports[0].candidates[i].sse != report.candidates[i].sse) ++failures;
+        }
+    }
+    std::printf("%s\n", failures ? "FAILED: multi-start worse than single start or depends on thread count" : "OK");
+    return failures ? 1 : 0;
+}
+
+int benchEvolution(int argc, char** argv)
+{
+    int population = argc > 0 ? std::atoi(argv[0]) : 0;
+    int threads = argc > 1 ? std::atoi(argv[1]) : 0;
+    double noise = argc > 2 ? std::atof(argv[2]) : 0.01;
+
+    // 探索使用低精度模型 (Stehfest N = 4)，LM 精修与单起点对照使用 N = 8
+    FitBenchProblem cheap, full;
+    setupFitBench(cheap, 60, noise, 4);
+    setupFitBench(full, 60, noise, 8);
+    Eigen::VectorXd start(6);
+    start << -1.5, -5.5, std::log10(0.05), -5.0, -0.5, 8.0;
+
+    std::printf("evolution benchmark: Model_1, 6 parameters, noise %.3g, threads = %d\n", noise,
+                ModelThreadPool::resolveThreadCount(threads));
+    ModelFitter::Options lm;
+    lm.targetMSE = 0.0;
+
+    auto begin = std::chrono::steady_clock::now();
+    ModelFitter::Report single = ModelFitter::levenbergMarquardt(start, full.problem, lm);
+    double singleMs = elapsedMs(begin);
+    const int m = std::max(single.residualCount, 1);
+    std::printf("  single LM:        %6lld evals %9.1f ms   MSE %.4e (%s)\n", single.evaluations, singleMs,
+                single.sse / m, ModelFitter::reasonName(single.reason));
+
+    ModelFitter::EvolutionOptions options;
+    options.populationSize = population;
+    ModelFitter::EvolutionReport reports[2];
+    const int threadCounts[2] = { 1, threads };
+    double deMs = 0.0;
+    for (int pass = 0; pass < 2; ++pass) {
+        options.threadCount = threadCounts[pass];
+        cheap.calls = 0;
+        begin = std::chrono::steady_clock::now();
+        reports[pass] = ModelFitter::differentialEvolution(start, cheap.problem, options);
+        deMs = elapsedMs(begin);
+        if (reports[pass].evaluations != cheap.calls) reports[pass].sse = HUGE_VAL;
+    }
+    const ModelFitter::EvolutionReport& de = reports[1];
+    std::printf("  DE (N=4):         %6lld evals %9.1f ms   MSE %.4e (%d x %d, %s)\n", de.evaluations, deMs, de.sse / m,
+                de.generations, de.populationSize, ModelFitter::reasonName(de.reason));
+
+    begin = std::chrono::steady_clock::now();
+    ModelFitter::Report refined = ModelFitter::levenbergMarquardt(de.u, full.problem, lm);
+    double refineMs = elapsedMs(begin);
+    std::printf("  LM refine (N=8):  %6lld evals %9.1f ms   MSE %.4e (%s)\n", refined.evaluations, refineMs,
+                refined.sse / m, ModelFitter::reasonName(refined.reason));
+
+    // 检查: 计数一致、DE + LM 不差于单起点 LM、DE 结果与线程数无关
+    int failures = 0;
+    if (!std::isfinite(de.sse) || !std::isfinite(reports[0].sse)) ++failures;
+    if (reports[0].sse != de.sse || reports[0].generations != de.generations) ++failures;
+    if (!(refined.sse <= single.sse * (1.0 + 1e-9))) ++failures;
+    std::printf("%s\n", failures ? "FAILED: DE + LM worse than single start or depends on thread count" : "OK");
+    return failures ? 1 : 0;
+}
+
+const Bench benches[] = {
+    { "inversion", "[nf=4]", benchInversion },
+    { "derivative", "[nf=4]", benchDerivative },
+    { "grid", "[points=20000] [nf=4]", benchGrid },
+    { "master", "[points=300] [nf=4]", benchMaster },
+    { "response", "[points=300] [nf=4]", benchResponse },
+    { "laplace", "[nf=4] [min ms=300]", benchLaplace },
+    { "alloc", "", benchAlloc },
+    { "scaling", "[model=2] [max nf=256] [min ms=200]", benchScaling },
+    { "cache", "[sets=6]", benchCache },
+    { "aligned", "[points=100] [N=8]", benchAligned },
+    { "batch", "[nf=4] [threads=1]", benchBatch },
+    { "sweep", "[threads=0] [file=modelbench_sweep.bin]", benchSweep },
+    { "fit", "[points=60] [max iterations=50] [noise=0.01] [start=0.25]", benchFit },
+    { "multistart", "[starts=16] [threads=0] [noise=0.01]", benchMultiStart },
+    { "evolution", "[population=0] [threads=0] [noise=0.01]", benchEvolution },
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::printf("usage: modelbench <benchmark> [args]\n");
+        for (const Bench& b : benches) std::printf("  %-12s %s\n", b.name, b.usage);
+        return 0;
+    }
+    for (const Bench& b : benches) {
+        if (std::strcmp(argv[1], b.name) == 0) return b.func(argc - 2, argv + 2);
+    }
+    std::fprintf(stderr, "unknown benchmark: %s\n", argv[1]);
+    return 1;
+}
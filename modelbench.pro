@@ -0,0 +1,16 @@
+######################################################################
+# 模型计算内核基准测试程序 (控制台，无界面)
+# 用法: modelbench [基准名称] [参数...]，不带参数时列出全部基准
+######################################################################
+TEMPLATE = app
+TARGET = modelbench
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+QMAKE_CXXFLAGS += -O3
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
+
+include(modelkernel.pri)
+
+SOURCES += $$PWD/modelbench.cpp
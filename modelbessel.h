@@ -0,0 +1,50 @@
+/*
+ * 文件名: modelbessel.h
+ * 文件作用: 模型计算内核使用的批量 (SIMD) 修正贝塞尔函数头文件 (无 Qt 依赖)
+ * 功能描述:
+ * 1. 计算指数缩放的修正贝塞尔函数:
+ *    K0e(x) = e^x K0(x), K1e(x) = e^x K1(x), I0e(x) = e^-x I0(x), I1e(x) = e^-x I1(x)。
+ *    缩放形式在大宗量下不会溢出，调用方按需乘回 e^±x。
+ * 2. 采用与 Boost.Math 双精度实现相同的有理逼近系数，相对误差与 Boost 一致 (约 1e-15)。
+ * 3. 数组接口一次处理一批宗量: 编译时开启 AVX-512 (__AVX512F__) 时每次处理 8 个，
+ *    开启 AVX2 (__AVX2__) 时每次处理 4 个，否则使用标量实现。见 modelkernel.pri 中的 model_avx2/model_avx512 选项。
+ * 4. 宗量要求: K0e/K1e 为 x > 0；I0e/I1e 为任意实数。
+ * 5. 另提供复宗量 (Re z >= 0) 的标量版本，供复拉普拉斯变量上的反演算法 (Talbot/de Hoog/Euler) 使用:
+ *    |z| <= 2 时用幂级数；2 < |z| <= 17 时 K 用 Steed 连分式 (CF2)，I 由 I1/I0 连分式 (CF1) 与 Wronskian 关系得到；
+ *    |z| > 17 时用 Hankel 渐近展开。
+ */
+
+#ifndef MODELBESSEL_H
+#define MODELBESSEL_H
+
+#include <complex>
+
+namespace ModelBessel {
+
+// 单个宗量
+double k0e(double x);
+double k1e(double x);
+double i0e(double x);
+double i1e(double x);
+
+// 批量计算: out[i] = f(x[i]), i = 0 .. n-1 (out 可以与 x 相同)
+void k0eArray(const double* x, double* out, int n);
+void k1eArray(const double* x, double* out, int n);
+void i0eArray(const double* x, double* out, int n);
+void i1eArray(const double* x, double* out, int n);
+
+// 批量指数函数 out[i] = exp(x[i])，与上述函数使用同一套向量实现
+void expArray(const double* x, double* out, int n);
+
+// 复宗量 (Re z >= 0): 一次同时计算 K0e, K1e, I0e, I1e (缩放方式同实宗量，e^±z 为复指数)
+void scaledBesselKI(std::complex<double> z, std::complex<double>& k0e, std::complex<double>& k1e,
+                    std::complex<double>& i0e, std::complex<double>& i1e);
+std::complex<double> k0e(std::complex<double> z);
+std::complex<double> i0e(std::complex<double> z);
+
+// 当前编译使用的指令集 ("AVX-512" / "AVX2" / "Scalar")
+const char* instructionSet();
+
+} // namespace ModelBessel
+
+#endif // MODELBESSEL_H
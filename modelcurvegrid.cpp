@@ -0,0 +1,411 @@
+/*
+ * 文件名: modelcurvegrid.cpp
+ * 文件作用: 自适应对数时间网格与对数-对数单调三次插值实现
+ * 功能描述:
+ * 1. LogLogCurve 的构造 (斜率估计与 Fritsch-Carlson 单调限制) 与求值。
+ * 2. ModelCurveGrid::evaluate: 初始对数网格 -> 逐轮四分点检查与四等分加密 -> 插值到请求时间点。
+ *    每轮的所有检查点一次性交给 ModelKernel 计算，各时间点的反演仍按线程池并行。
+ *    初始网格为 2 的整数次幂，各轮节点都落在尺度为 2 的格点上，Stehfest 节点在相邻倍程间复用。
+ *    只查中点会漏掉偏离中点的误差峰 (Hermite 两端斜率误差在中点处相互抵消)，因此每个区间查三个点。
+ * 3. 主曲线缓存: 以无因次参数 (含反演算法与阶数) 为键，按最近使用顺序保留 MasterCacheSize 组，
+ *    互斥锁只保护查找与插入，构造主曲线时不持锁。曲线范围截到包含请求范围的达标区间；
+ *    请求范围内达不到误差要求的参数组只记录失败 (不保存曲线)，同一参数组的后续请求直接逐点计算，不再重复加密。
+ */
+
+#include "modelcurvegrid.h"
+#include "modelkernel.h"
+
+#include <cmath>
+#include <algorithm>
+#include <mutex>
+
+namespace {
+
+// 导数相对误差分母的下限 (相对于曲线最大值)
+const double DerivativeFloor = 1e-6;
+
+// 检查点只覆盖区间内三个位置，点间误差可能更高: 区间误差不超过 relTol 的这一比例才算达标
+const double RefineFraction = 0.25;
+
+// 三次 Hermite 基函数插值
+inline double hermite(double x0, double x1, double y0, double y1, double m0, double m1, double x)
+{
+    double h = x1 - x0;
+    double s = (x - x0) / h;
+    double s2 = s * s, s3 = s2 * s;
+    return (2 * s3 - 3 * s2 + 1) * y0 + (s3 - 2 * s2 + s) * h * m0 + (-2 * s3 + 3 * s2) * y1 + (s3 - s2) * h * m1;
+}
+
+double relativeError(double approx, double exact, double floorValue)
+{
+    return std::abs(approx - exact) / std::max(std::abs(exact), floorValue);
+}
+
+// 请求中正时间点的范围，没有正值时返回 false
+bool positiveRange(const std::vector<double>& tD, double& tMin, double& tMax, int& valid)
+{
+    tMin = HUGE_VAL; tMax = 0.0; valid = 0;
+    for (double t : tD) {
+        if (t > 1e-12) { tMin = std::min(tMin, t); tMax = std::max(tMax, t); ++valid; }
+    }
+    return valid > 0;
+}
+
+// 请求点数不多于约两倍初始网格节点时，构造网格比逐点计算更贵
+bool fewPoints(int valid, double tMin, double tMax)
+{
+    int initialIntervals = std::max(2, (int)std::ceil((valid > 0 ? std::log10(tMax / tMin) : 0.0) * ModelCurveGrid::NodesPerDecade));
+    return valid <= 2 * initialIntervals + 1 || !(tMax > tMin);
+}
+
+// 决定 pD(tD) 的全部参数 (线程数不影响结果，不计入)
+bool sameDimensionless(const ModelContext& a, const ModelContext& b)
+{
+    return a.type == b.type && a.kf == b.kf && a.km == b.km && a.LfD == b.LfD && a.rmD == b.rmD
+        && a.reD == b.reD && a.omega1 == b.omega1 && a.omega2 == b.omega2 && a.lambda1 == b.lambda1
+        && a.gamaD == b.gamaD && a.cD == b.cD && a.S == b.S && a.nf == b.nf
+        && a.inversionMethod == b.inversionMethod && a.stehfestN == b.stehfestN
+        && a.inversionOrder == b.inversionOrder;
+}
+
+// curve 为空表示该参数组在 [tMin, tMax]、relTol 下构造失败
+struct MasterEntry
+{
+    ModelContext ctx;
+    std::shared_ptr<const MasterCurve> curve;
+    double tMin, tMax, relTol;
+    CurveGridReport report;
+};
+
+std::mutex s_masterMutex;
+std::vector<MasterEntry> s_masterCache;   // 按最近使用排序，最新的在前
+
+} // namespace
+
+void LogLogCurve::build(const std::vector<double>& t, const std::vector<double>& v)
+{
+    int n = (int)t.size();
+    m_x.resize(n); m_y.resize(n); m_m.assign(n, 0.0);
+    m_logValues = true;
+    for (int i = 0; i < n; ++i) {
+        if (!(v[i] > 0.0)) { m_logValues = false; break; }
+    }
+    for (int i = 0; i < n; ++i) {
+        m_x[i] = std::log(t[i]);
+        m_y[i] = m_logValues ? std::log(v[i]) : v[i];
+    }
+    if (n < 2) return;
+
+    std::vector<double> delta(n - 1);
+    for (int i = 0; i < n - 1; ++i) delta[i] = (m_y[i + 1] - m_y[i]) / (m_x[i + 1] - m_x[i]);
+
+    if (n == 2) {
+        m_m[0] = m_m[1] = delta[0];
+    } else {
+        // 内部节点取过相邻三点的抛物线斜率 (光滑段二阶精度)，相邻割线斜率符号相反时取 0
+        for (int i = 1; i < n - 1; ++i) {
+            if (delta[i - 1] * delta[i] <= 0.0) { m_m[i] = 0.0; continue; }
+            double h0 = m_x[i] - m_x[i - 1], h1 = m_x[i + 1] - m_x[i];
+            m_m[i] = (h1 * delta[i - 1] + h0 * delta[i]) / (h0 + h1);
+        }
+        // 端点: 三点单侧公式，并保持形状
+        auto endSlope = [](double h0, double h1, double d0, double d1) {
+            double m = ((2 * h0 + h1) * d0 - h0 * d1) / (h0 + h1);
+            if (m * d0 <= 0.0) return 0.0;
+            if (d0 * d1 <= 0.0 && std::abs(m) > std::abs(3 * d0)) return 3 * d0;
+            return m;
+        };
+        m_m[0] = endSlope(m_x[1] - m_x[0], m_x[2] - m_x[1], delta[0], delta[1]);
+        m_m[n - 1] = endSlope(m_x[n - 1] - m_x[n - 2], m_x[n - 2] - m_x[n - 3], delta[n - 2], delta[n - 3]);
+    }
+
+    // Fritsch-Carlson 限制器: 保证每个区间上插值单调
+    for (int i = 0; i < n - 1; ++i) {
+        if (delta[i] == 0.0) { m_m[i] = m_m[i + 1] = 0.0; continue; }
+        double a = m_m[i] / delta[i], b = m_m[i + 1] / delta[i];
+        if (a < 0.0) { m_m[i] = 0.0; a = 0.0; }
+        if (b < 0.0) { m_m[i + 1] = 0.0; b = 0.0; }
+        double r = a * a + b * b;
+        if (r > 9.0) {
+            double tau = 3.0 / std::sqrt(r);
+            m_m[i] = tau * a * delta[i];
+            m_m[i + 1] = tau * b * delta[i];
+        }
+    }
+}
+
+double LogLogCurve::value(double t) const
+{
+    int n = (int)m_x.size();
+    if (n == 0) return 0.0;
+    double y;
+    if (n == 1) {
+        y = m_y[0];
+    } else {
+        double x = std::log(t);
+        if (x <= m_x[0]) {
+            y = m_y[0] + m_m[0] * (x - m_x[0]);
+        } else if (x >= m_x[n - 1]) {
+            y = m_y[n - 1] + m_m[n - 1] * (x - m_x[n - 1]);
+        } else {
+            int i = (int)(std::upper_bound(m_x.begin(), m_x.end(), x) - m_x.begin()) - 1;
+            y = hermite(m_x[i], m_x[i + 1], m_y[i], m_y[i + 1], m_m[i], m_m[i + 1], x);
+        }
+    }
+    return m_logValues ? std::exp(y) : y;
+}
+
+double LogLogCurve::minTime() const { return m_x.empty() ? 0.0 : std::exp(m_x.front()); }
+double LogLogCurve::maxTime() const { return m_x.empty() ? 0.0 : std::exp(m_x.back()); }
+
+void MasterCurve::evaluate(const std::vector<double>& tD, std::vector<double>& outPD, std::vector<double>& outDeriv) const
+{
+    outPD.assign(tD.size(), 0.0);
+    outDeriv.assign(tD.size(), 0.0);
+    for (size_t k = 0; k < tD.size(); ++k) {
+        if (tD[k] <= 1e-12) continue;
+        outPD[k] = pd.value(tD[k]);
+        outDeriv[k] = deriv.value(tD[k]);
+    }
+}
+
+void ModelCurveGrid::evaluate(const std::vector<double>& tD, const ModelContext& ctx, double relTol,
+                              std::vector<double>& outPD, std::vector<double>& outDeriv, CurveGridReport* report)
+{
+    if (report) *report = CurveGridReport();
+
+    // 请求的时间范围 (tD <= 1e-12 的点与逐点计算一致输出 0)
+    double tMin, tMax;
+    int valid;
+    positiveRange(tD, tMin, tMax, valid);
+    if (fewPoints(valid, tMin, tMax)) {
+        ModelKernel::calculatePDAndDerivative(tD, ctx, outPD, outDeriv);
+        if (report) { report->direct = true; report->nodeCount = (int)tD.size(); }
+        return;
+    }
+
+    MasterCurve curve;
+    curve.tMin = tMin; curve.tMax = tMax; curve.relTol = relTol;
+    const bool passed = buildCurves(tMin, tMax, ctx, relTol, curve);
+    if (report) *report = curve.report;
+    if (!passed) {
+        // 网格达不到误差要求: 逐点计算 (报告中保留网格的误差估计)
+        ModelKernel::calculatePDAndDerivative(tD, ctx, outPD, outDeriv);
+        if (report) report->direct = true;
+        return;
+    }
+    curve.evaluate(tD, outPD, outDeriv);
+}
+
+std::shared_ptr<const MasterCurve> ModelCurveGrid::masterCurve(const std::vector<double>& tD, const ModelContext& ctx,
+                                                               double relTol, CurveGridReport* report)
+{
+    if (report) *report = CurveGridReport();
+    double tMin, tMax;
+    int valid;
+    if (!positiveRange(tD, tMin, tMax, valid)) return nullptr;
+    const double requestMin = tMin, requestMax = tMax;
+
+    // 1. 查找覆盖请求范围的缓存曲线；同一参数组范围不够时，新曲线取两者范围的并集。
+    //    同一参数组在更宽的范围、不低于本次的误差要求下已构造失败时，直接逐点计算
+    {
+        std::lock_guard<std::mutex> lock(s_masterMutex);
+        for (size_t i = 0; i < s_masterCache.size(); ++i) {
+            const MasterEntry& e = s_masterCache[i];
+            if (!sameDimensionless(e.ctx, ctx)) continue;
+            if (!e.curve) {
+                if (relTol <= e.relTol && requestMin >= e.tMin && requestMax <= e.tMax) {
+                    if (report) { report->direct = true; report->nodeCount = valid; report->maxErrorEstimate = e.report.maxErrorEstimate; }
+                    return nullptr;
+                }
+                continue;
+            }
+            if (e.relTol > relTol) continue;
+            if (e.curve->covers(requestMin, requestMax)) {
+                std::rotate(s_masterCache.begin(), s_masterCache.begin() + i, s_masterCache.begin() + i + 1);
+                std::shared_ptr<const MasterCurve> hit = s_masterCache.front().curve;
+                if (report) { *report = hit->report; report->cached = true; }
+                return hit;
+            }
+            tMin = std::min(tMin, e.tMin);
+            tMax = std::max(tMax, e.tMax);
+        }
+    }
+
+    // 2. 缓存未命中且请求点数少时，构造网格比逐点计算更贵
+    if (fewPoints(valid, requestMin, requestMax)) {
+        if (report) { report->direct = true; report->nodeCount = valid; }
+        return nullptr;
+    }
+
+    // 3. 构造 (不持锁)。两端留余量，使比例参数的扰动与 LM 试探步仍落在曲线范围内
+    std::shared_ptr<MasterCurve> curve = std::make_shared<MasterCurve>();
+    double margin = std::pow(10.0, MasterMargin);
+    curve->tMin = std::max(tMin / margin, 1e-12);
+    curve->tMax = tMax * margin;
+    curve->relTol = relTol;
+    const bool failed = !buildCurves(requestMin, requestMax, ctx, relTol, *curve);
+    if (report) { *report = curve->report; report->direct = failed; }
+
+    // 4. 插入缓存 (替换同一参数组的旧记录)。超差的曲线不保存、不返回，只记录失败
+    std::lock_guard<std::mutex> lock(s_masterMutex);
+    for (size_t i = 0; i < s_masterCache.size(); ++i) {
+        if (sameDimensionless(s_masterCache[i].ctx, ctx)) { s_masterCache.erase(s_masterCache.begin() + i); break; }
+    }
+    MasterEntry entry{ ctx, failed ? nullptr : curve, curve->tMin, curve->tMax, relTol, curve->report };
+    s_masterCache.insert(s_masterCache.begin(), entry);
+    if ((int)s_masterCache.size() > MasterCacheSize) s_masterCache.resize(MasterCacheSize);
+    if (failed) return nullptr;
+    return curve;
+}
+
+void ModelCurveGrid::clearMasterCache()
+{
+    std::lock_guard<std::mutex> lock(s_masterMutex);
+    s_masterCache.clear();
+}
+
+bool ModelCurveGrid::buildCurves(double coreMin, double coreMax, const ModelContext& ctx, double relTol, MasterCurve& curve)
+{
+    LogLogCurve& pdCurve = curve.pd;
+    LogLogCurve& derivCurve = curve.deriv;
+    const double tMin = curve.tMin, tMax = curve.tMax;
+    const double target = relTol * RefineFraction;
+
+    // 1. 初始网格取覆盖 [tMin, tMax] 的 2 的整数次幂 (每倍程一个节点，约每十倍程 3.3 个)。
+    //    对数中点与四分点 (逐次取 sqrt(a·b)) 也是尺度为 2 的格点，相邻倍程的 Stehfest 节点重合，
+    //    同一轮内由内核去重，跨轮次由储层响应缓存复用
+    int jMin = (int)std::floor(std::log2(tMin)), jMax = (int)std::ceil(std::log2(tMax));
+    jMax = std::max(jMax, jMin + 2);
+    int initialIntervals = jMax - jMin;
+    std::vector<double> nodeT(initialIntervals + 1);
+    for (int i = 0; i <= initialIntervals; ++i) nodeT[i] = std::ldexp(1.0, jMin + i);
+    std::vector<double> nodePD, nodeDeriv;
+    ModelKernel::calculatePDAndDerivative(nodeT, ctx, nodePD, nodeDeriv);
+
+    // 2. 每个区间在对数四分点与中点各留一个检查点 (不并入网格)，用当前曲线检查:
+    //    误差超过 target 的区间把自己的三个检查点并入网格 (四等分)，新区间下一轮计算检查点；
+    //    并入节点会改变相邻节点的斜率，端点斜率有变化的旧区间用已存的检查点值重新检查 (不再反演)。
+    //    循环结束时每个区间的误差都是在最终曲线上检查得到的
+    struct Interval
+    {
+        int level = 0;
+        bool evaluated = false;     // 检查点已计算
+        bool checked = false;       // 已在当前曲线上检查
+        double err = 0.0;
+        double t[3], pd[3], deriv[3];
+    };
+    std::vector<Interval> intervals((size_t)initialIntervals);
+    pdCurve.build(nodeT, nodePD);
+    derivCurve.build(nodeT, nodeDeriv);
+
+    int rounds = 0;
+    for (;;) {
+        std::vector<size_t> fresh;
+        for (size_t k = 0; k < intervals.size(); ++k) {
+            if (!intervals[k].evaluated) fresh.push_back(k);
+        }
+        if (!fresh.empty()) {
+            std::vector<double> checkT(3 * fresh.size()), checkPD, checkDeriv;
+            for (size_t f = 0; f < fresh.size(); ++f) {
+                double a = nodeT[fresh[f]], b = nodeT[fresh[f] + 1], mid = std::sqrt(a * b);
+                checkT[3 * f] = std::sqrt(a * mid);
+                checkT[3 * f + 1] = mid;
+                checkT[3 * f + 2] = std::sqrt(mid * b);
+            }
+            ModelKernel::calculatePDAndDerivative(checkT, ctx, checkPD, checkDeriv);
+            ++rounds;
+            for (size_t f = 0; f < fresh.size(); ++f) {
+                Interval& iv = intervals[fresh[f]];
+                for (int c = 0; c < 3; ++c) {
+                    iv.t[c] = checkT[3 * f + c]; iv.pd[c] = checkPD[3 * f + c]; iv.deriv[c] = checkDeriv[3 * f + c];
+                }
+                iv.evaluated = true;
+            }
+        }
+
+        // 导数误差的分母随节点增加只会变大，已检查区间的误差仍是上界
+        double derivScale = 0.0;
+        for (double d : nodeDeriv) derivScale = std::max(derivScale, std::abs(d));
+        double derivFloor = std::max(DerivativeFloor * derivScale, 1e-300);
+
+        std::vector<bool> split(intervals.size(), false);
+        int splitCount = 0;
+        for (size_t k = 0; k < intervals.size(); ++k) {
+            Interval& iv = intervals[k];
+            if (iv.checked) continue;
+            iv.err = 0.0;
+            for (int c = 0; c < 3; ++c) {
+                double e = std::max(relativeError(pdCurve.value(iv.t[c]), iv.pd[c], 1e-300),
+                                    relativeError(derivCurve.value(iv.t[c]), iv.deriv[c], derivFloor));
+                // 非有限值 (模型在该处无定义) 视为无法插值
+                iv.err = std::isfinite(e) ? std::max(iv.err, e) : HUGE_VAL;
+            }
+            iv.checked = true;
+            if (iv.err > target && iv.level < MaxLevels) { split[k] = true; ++splitCount; }
+        }
+        // 没有需要加密的区间，或节点数将超过上限 (此时各区间误差都已在当前曲线上检查)
+        if (splitCount == 0 || (int)nodeT.size() + 3 * splitCount > MaxNodes) break;
+
+        // 并入超限区间的检查点；oldIndex 记录旧节点在新网格中的位置
+        std::vector<double> t2, p2, d2;
+        std::vector<Interval> next;
+        std::vector<int> oldIndex(nodeT.size());
+        t2.reserve(nodeT.size() + 3 * splitCount); p2.reserve(t2.capacity()); d2.reserve(t2.capacity());
+        for (size_t k = 0; k < nodeT.size(); ++k) {
+            oldIndex[k] = (int)t2.size();
+            t2.push_back(nodeT[k]); p2.push_back(nodePD[k]); d2.push_back(nodeDeriv[k]);
+            if (k + 1 == nodeT.size()) break;
+            if (!split[k]) { next.push_back(intervals[k]); continue; }
+            const Interval& iv = intervals[k];
+            for (int c = 0; c < 3; ++c) { t2.push_back(iv.t[c]); p2.push_back(iv.pd[c]); d2.push_back(iv.deriv[c]); }
+            Interval child;
+            child.level = iv.level + 1;
+            for (int c = 0; c < 4; ++c) next.push_back(child);
+        }
+
+        const std::vector<double> oldPdSlopes = pdCurve.slopes(), oldDerivSlopes = derivCurve.slopes();
+        const bool oldPdLog = pdCurve.logValues(), oldDerivLog = derivCurve.logValues();
+        nodeT.swap(t2); nodePD.swap(p2); nodeDeriv.swap(d2);
+        intervals.swap(next);
+        pdCurve.build(nodeT, nodePD);
+        derivCurve.build(nodeT, nodeDeriv);
+
+        // 端点斜率 (或插值空间) 有变化的旧区间需要重新检查
+        const bool allChanged = pdCurve.logValues() != oldPdLog || derivCurve.logValues() != oldDerivLog;
+        const std::vector<double>& pdSlopes = pdCurve.slopes();
+        const std::vector<double>& derivSlopes = derivCurve.slopes();
+        for (size_t k = 0; k + 1 < oldIndex.size(); ++k) {
+            size_t i0 = (size_t)oldIndex[k], i1 = (size_t)oldIndex[k + 1];
+            if (i1 != i0 + 1) continue;     // 已加密的区间
+            if (allChanged || pdSlopes[i0] != oldPdSlopes[k] || pdSlopes[i1] != oldPdSlopes[k + 1]
+                || derivSlopes[i0] != oldDerivSlopes[k] || derivSlopes[i1] != oldDerivSlopes[k + 1]) {
+                intervals[i0].checked = false;
+            }
+        }
+    }
+
+    // 3. 有效范围: 从覆盖 [coreMin, coreMax] 的区间向两侧延伸到第一个不达标的区间为止
+    size_t lo = (size_t)(std::upper_bound(nodeT.begin(), nodeT.end(), coreMin) - nodeT.begin());
+    lo = lo > 0 ? lo - 1 : 0;
+    size_t hi = (size_t)(std::lower_bound(nodeT.begin(), nodeT.end(), coreMax) - nodeT.begin());
+    hi = std::min(std::max(hi, (size_t)1) - 1, intervals.size() - 1);
+    lo = std::min(lo, hi);
+    double maxError = 0.0;
+    for (size_t k = lo; k <= hi; ++k) maxError = std::max(maxError, intervals[k].err);
+    const bool passed = maxError <= target;
+    if (passed) {
+        while (lo > 0 && intervals[lo - 1].err <= target) --lo;
+        while (hi + 1 < intervals.size() && intervals[hi + 1].err <= target) ++hi;
+        for (size_t k = lo; k <= hi; ++k) maxError = std::max(maxError, intervals[k].err);
+        curve.tMin = std::max(tMin, nodeT[lo]);
+        curve.tMax = std::min(tMax, nodeT[hi + 1]);
+    }
+
+    CurveGridReport& report = curve.report;
+    report.direct = false;
+    report.nodeCount = (int)nodeT.size();
+    report.refinementRounds = rounds;
+    report.maxErrorEstimate = maxError;
+    return passed;
+}
@@ -0,0 +1,104 @@
+/*
+ * 文件名: modelcurvegrid.h
+ * 文件作用: 自适应对数时间网格与对数-对数单调三次插值头文件 (纯 C++ 实现，无 Qt 依赖)
+ * 功能描述:
+ * 1. LogLogCurve: 在 (ln t, ln v) 空间做单调三次 Hermite 插值 (Fritsch-Carlson 限制器)；
+ *    节点斜率只由节点值估计 (三点抛物线斜率)，曲线含非正值时退化为 (ln t, v) 空间插值。
+ *    pD 不使用单独反演的导数作斜率: 低阶 Stehfest 下两者各有误差，导数并不是 pD 插值曲线的斜率。
+ * 2. ModelCurveGrid::evaluate: 在请求时间范围内先按固定密度生成对数网格，再逐轮检查每个区间的
+ *    对数四分点与中点，插值相对误差超过 relTol/2 的区间四等分加密，最后将 pD 与导数插值到请求的时间点。
+ *    检查点不并入网格，每个区间的误差都在最终曲线上检查；检查点之间的误差由 relTol/2 的余量覆盖。
+ *    计算量只取决于曲线形状与误差要求，与请求的时间点数基本无关 (高频采集数据的拟合)。
+ * 3. 请求点数不多于初始网格时直接逐点计算；请求范围内有区间加密到层数或节点上限仍达不到 relTol/2 时
+ *    (如应力敏感有界模型 pD 接近 1/gamaD 处的间断) 也改为逐点计算，不返回超差的插值结果。
+ * 4. 无因次主曲线缓存: ModelContext 只含无因次参数，phi、mu、Ct、q、B、h、L 只通过 tD 的比例因子与
+ *    压力系数进入理论曲线。masterCurve 按无因次参数组缓存 pD(tD) 插值曲线 (时间范围两端各留余量)，
+ *    这些参数的扰动只平移 tD，可直接在缓存曲线上插值，不再做任何拉普拉斯反演。
+ *    主曲线只保留包含请求范围的一段达标区间 (余量内不达标的部分被截掉，如定压边界晚期导数的舍入噪声)；
+ *    请求范围本身不达标的曲线不缓存也不返回，调用方改为逐点计算。
+ */
+
+#ifndef MODELCURVEGRID_H
+#define MODELCURVEGRID_H
+
+#include <vector>
+#include <memory>
+
+struct ModelContext;
+
+// 对数-对数空间的单调三次插值曲线 v(t)，t > 0
+class LogLogCurve
+{
+public:
+    // t 严格递增
+    void build(const std::vector<double>& t, const std::vector<double>& v);
+
+    // 插值 (超出节点范围时按端点斜率外推)
+    double value(double t) const;
+
+    bool isEmpty() const { return m_x.empty(); }
+    bool logValues() const { return m_logValues; }
+    const std::vector<double>& slopes() const { return m_m; }   // 各节点的 dy/dx (y 为 ln v 或 v)
+    double minTime() const;
+    double maxTime() const;
+
+private:
+    bool m_logValues = true;    // 是否在 ln v 空间插值
+    std::vector<double> m_x;    // ln t
+    std::vector<double> m_y;    // ln v 或 v
+    std::vector<double> m_m;    // dy/dx
+};
+
+// 自适应网格计算的诊断信息
+struct CurveGridReport
+{
+    bool direct = false;            // 是否直接逐点计算 (点数少或网格达不到误差要求)
+    int nodeCount = 0;              // 网格节点数 (即实际反演的时间点数)
+    int refinementRounds = 0;       // 加密轮数
+    double maxErrorEstimate = 0.0;  // 曲线有效范围内检查点的最大相对插值误差 (不超过 relTol/2，否则已改为逐点计算)
+    bool cached = false;            // 是否直接使用了缓存的主曲线 (没有任何反演)
+};
+
+// 某组无因次参数下的主曲线: [tMin, tMax] 内的 pD 与 tD·dpD/dtD 插值 (只含达到误差要求的区间)
+struct MasterCurve
+{
+    LogLogCurve pd;
+    LogLogCurve deriv;
+    double tMin = 0.0;
+    double tMax = 0.0;
+    double relTol = 0.0;
+    CurveGridReport report;         // 构造主曲线时的网格信息
+
+    bool covers(double t0, double t1) const { return t0 >= tMin && t1 <= tMax; }
+    // 插值到 tD (tD <= 1e-12 输出 0)
+    void evaluate(const std::vector<double>& tD, std::vector<double>& outPD, std::vector<double>& outDeriv) const;
+};
+
+class ModelCurveGrid
+{
+public:
+    static const int NodesPerDecade = 3;  // 初始网格密度 (请求点少于约两倍初始节点时直接逐点计算)
+    static const int MaxNodes = 2048;     // 节点总数上限
+    static const int MaxLevels = 4;       // 每个初始区间最多四等分的次数
+    static const int MasterCacheSize = 8; // 缓存的主曲线组数 (最近使用的保留)
+    static constexpr double MasterMargin = 1.0; // 主曲线时间范围在请求范围两端各扩展的对数周期数
+
+    // 计算 tD 处的 pD 与 tD·dpD/dtD (与 ModelKernel::calculatePDAndDerivative 输出一致，误差不超过 relTol)
+    // 导数误差的分母不小于 1e-6 * max|导数| (定压边界晚期导数趋于 0)
+    static void evaluate(const std::vector<double>& tD, const ModelContext& ctx, double relTol,
+                         std::vector<double>& outPD, std::vector<double>& outDeriv, CurveGridReport* report = nullptr);
+
+    // 取覆盖 tD 范围、误差不超过 relTol 的主曲线: 缓存命中时不做反演，否则构造后存入缓存 (线程安全)。
+    // 返回空指针时由调用方逐点计算: tD 中没有正值、缓存未命中且请求点数少 (同 evaluate)，
+    // 或网格达不到 relTol (该参数组记为失败，后续请求不再重复构造)
+    static std::shared_ptr<const MasterCurve> masterCurve(const std::vector<double>& tD, const ModelContext& ctx,
+                                                          double relTol, CurveGridReport* report = nullptr);
+    static void clearMasterCache();
+
+private:
+    // 在 [curve.tMin, curve.tMax] 上自适应构造 pD 与导数的插值曲线，并把 curve 的范围缩到
+    // 包含 [coreMin, coreMax] 的最长一段达标区间；[coreMin, coreMax] 内有区间不达标时返回 false
+    static bool buildCurves(double coreMin, double coreMax, const ModelContext& ctx, double relTol, MasterCurve& curve);
+};
+
+#endif // MODELCURVEGRID_H
@@ -0,0 +1,538 @@
+/*
+ * 文件名: modelfitter.cpp
+ * 文件作用: 非线性最小二乘拟合算法实现
+ * 功能描述:
+ * 1. 差分雅可比矩阵: 全部扰动点先生成再批量计算，列顺序与变量顺序一致，结果与并行方式无关。
+ * 2. Levenberg-Marquardt 主循环 (可选 Broyden 秩一更新)，JᵀJ 与 Jᵀr 只在 J 变化时重新计算；
+ *    同一 λ 下速度与加速度共用一次 LDLT 分解。
+ * 3. 多起点: 各起点的 LM 互相独立，经内核线程池并行 (起点内的差分批量计算自动串行)；
+ *    淘汰只按每轮结束时的误差排序，结果与线程数无关。
+ * 4. 差分进化: 随机数只在调用线程中按个体顺序使用，并行部分只计算残差，结果同样与线程数无关。
+ */
+
+#include "modelfitter.h"
+#include "modelthreadpool.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <numeric>
+#include <algorithm>
+
+std::vector<bool> ModelFitter::evaluate(const Problem& problem, const std::vector<Eigen::VectorXd>& us,
+                                        std::vector<Eigen::VectorXd>& rs, int expectedSize)
+{
+    rs.assign(us.size(), Eigen::VectorXd());
+    if (problem.batchResiduals) {
+        problem.batchResiduals(us, rs);
+    } else {
+        for (size_t i = 0; i < us.size(); ++i) {
+            if (!problem.residuals(us[i], rs[i])) rs[i].resize(0);
+        }
+    }
+    std::vector<bool> ok(us.size());
+    for (size_t i = 0; i < us.size(); ++i) {
+        ok[i] = rs[i].size() > 0 && (expectedSize <= 0 || rs[i].size() == expectedSize) && rs[i].allFinite();
+    }
+    return ok;
+}
+
+Eigen::VectorXd ModelFitter::clamp(const Eigen::VectorXd& u, const Problem& problem)
+{
+    Eigen::VectorXd out = u;
+    for (Eigen::Index i = 0; i < u.size(); ++i) {
+        if (i < problem.lower.size()) out[i] = std::max(out[i], problem.lower[i]);
+        if (i < problem.upper.size()) out[i] = std::min(out[i], problem.upper[i]);
+    }
+    return out;
+}
+
+Eigen::MatrixXd ModelFitter::finiteDifferenceJacobian(const Eigen::VectorXd& u, const Eigen::VectorXd& r,
+                                                      const Problem& problem, JacobianMode mode,
+                                                      long long* evaluations)
+{
+    const int n = (int)u.size();
+    const int m = (int)r.size();
+    const bool central = (mode == CentralDifference);
+
+    // 第 j 列的扰动点: 中心差分为 (u + h e_j, u - h e_j)，前向差分为 u + h e_j
+    std::vector<Eigen::VectorXd> points;
+    points.reserve(central ? 2 * n : n);
+    for (int j = 0; j < n; ++j) {
+        Eigen::VectorXd plus = u;
+        plus[j] += problem.steps[j];
+        points.push_back(plus);
+        if (central) {
+            Eigen::VectorXd minus = u;
+            minus[j] -= problem.steps[j];
+            points.push_back(minus);
+        }
+    }
+    std::vector<Eigen::VectorXd> rs;
+    std::vector<bool> ok = evaluate(problem, points, rs, m);
+    if (evaluations) *evaluations += (long long)points.size();
+
+    // 失败的扰动点对应的列置零 (该变量本次不更新)
+    Eigen::MatrixXd J = Eigen::MatrixXd::Zero(m, n);
+    for (int j = 0; j < n; ++j) {
+        const double h = problem.steps[j];
+        if (central) {
+            if (ok[2 * j] && ok[2 * j + 1]) J.col(j) = (rs[2 * j] - rs[2 * j + 1]) / (2.0 * h);
+        } else if (ok[j]) {
+            J.col(j) = (rs[j] - r) / h;
+        }
+    }
+    return J;
+}
+
+const char* ModelFitter::reasonName(StopReason reason)
+{
+    switch (reason) {
+    case TargetReached: return "target";
+    case MaxIterations: return "max-iterations";
+    case NoProgress: return "no-progress";
+    case Cancelled: return "cancelled";
+    case EvaluationFailed: return "evaluation-failed";
+    case SmallGradient: return "small-gradient";
+    case SmallStep: return "small-step";
+    case SmallReduction: return "small-reduction";
+    }
+    return "unknown";
+}
+
+ModelFitter::Report ModelFitter::levenbergMarquardt(const Eigen::VectorXd& u0, const Problem& problem,
+                                                    const Options& options)
+{
+    Report report;
+    Eigen::VectorXd u = clamp(u0, problem);
+    Eigen::VectorXd r;
+    report.u = u;
+    report.evaluations = 1;
+    if (!problem.residuals(u, r) || r.size() == 0 || !r.allFinite()) {
+        report.reason = EvaluationFailed;
+        return report;
+    }
+    const int m = (int)r.size();
+    double sse = r.squaredNorm();
+    report.residualCount = m;
+
+    double lambda = options.initialLambda;
+    double nu = 2.0;            // Nielsen: 连续拒绝时 λ 的放大倍数
+    Eigen::MatrixXd J, H;
+    Eigen::VectorXd g;
+    bool fresh = false;         // J 是否为当前点的完整差分
+    bool needRebuild = true;
+    int sinceRebuild = 0;
+
+    auto rebuild = [&]() {
+        J = finiteDifferenceJacobian(u, r, problem, options.jacobian, &report.jacobianEvaluations);
+        H = J.transpose() * J;
+        g = J.transpose() * r;
+        ++report.jacobianBuilds;
+        fresh = true;
+        needRebuild = false;
+        sinceRebuild = 0;
+    };
+    auto evaluateAt = [&](const Eigen::VectorXd& x, Eigen::VectorXd& rx) {
+        ++report.evaluations;
+        return problem.residuals(x, rx) && rx.size() == m && rx.allFinite();
+    };
+
+    report.reason = MaxIterations;
+    for (int iter = 0; iter < options.maxIterations; ++iter) {
+        if (problem.shouldContinue && !problem.shouldContinue(iter)) {
+            report.reason = Cancelled;
+            break;
+        }
+        // 收敛判据：如果均方误差足够小，提前结束
+        if (options.targetMSE > 0.0 && sse / m < options.targetMSE) {
+            report.reason = TargetReached;
+            break;
+        }
+
+        Iteration info;
+        info.iteration = iter;
+        if (!options.broyden || needRebuild || sinceRebuild >= options.rebuildInterval) {
+            rebuild();
+            info.jacobianRebuilt = true;
+        }
+        info.gradientNorm = g.lpNorm<Eigen::Infinity>();
+        if (fresh && info.gradientNorm <= options.gradientTolerance) {
+            report.reason = SmallGradient;
+            break;
+        }
+
+        bool accepted = false;
+        bool converged = false;
+        for (int tryIter = 0; tryIter < options.maxRetries; ++tryIter) {
+            ++info.trials;
+            Eigen::MatrixXd Hlm = H;
+            for (int i = 0; i < Hlm.rows(); ++i) Hlm(i, i) += lambda * (1.0 + std::abs(H(i, i)));
+            Eigen::LDLT<Eigen::MatrixXd> ldlt(Hlm);
+            Eigen::VectorXd v = ldlt.solve(-g);
+            Eigen::VectorXd step = v;
+            bool geodesicUsed = false;
+
+            if (options.geodesic && v.squaredNorm() > 0.0) {
+                // r'' ≈ 2 (r(u + h·v) - r - J·h·v) / h²，按截断后的实际位移计算
+                const double h = options.geodesicStep;
+                Eigen::VectorXd d = clamp(u + h * v, problem) - u;
+                Eigen::VectorXd rh;
+                ++report.geodesicEvaluations;
+                if (evaluateAt(u + d, rh)) {
+                    Eigen::VectorXd rpp = (2.0 / (h * h)) * (rh - r - J * d);
+                    Eigen::VectorXd acc = ldlt.solve(-(J.transpose() * rpp));
+                    if (2.0 * acc.norm() <= options.geodesicRatio * v.norm()) {
+                        step = v + 0.5 * acc;
+                        geodesicUsed = true;
+                    }
+                }
+            }
+
+            Eigen::VectorXd uTrial = clamp(u + step, problem);
+            Eigen::VectorXd s = uTrial - u;
+            Eigen::VectorXd rTrial;
+            bool ok = evaluateAt(uTrial, rTrial);
+            double sseTrial = ok ? rTrial.squaredNorm() : std::numeric_limits<double>::infinity();
+            // 线性模型预测的下降量 (按截断后的实际步长)
+            double predicted = sse - (r + J * s).squaredNorm();
+            info.rho = predicted > 0.0 && ok ? (sse - sseTrial) / predicted : 0.0;
+
+            if (sseTrial < sse) {
+                const bool fromFresh = fresh;
+                const double reduction = (sse - sseTrial) / sse;
+                const bool smallStep = s.norm() <= options.stepTolerance * (u.norm() + options.stepTolerance);
+                if (options.broyden && s.squaredNorm() > 0.0) {
+                    J += ((rTrial - r - J * s) * s.transpose()) / s.squaredNorm();
+                    ++report.broydenUpdates;
+                    ++sinceRebuild;
+                    fresh = false;
+                    needRebuild = info.rho < options.rebuildRatio;
+                }
+                u = uTrial;
+                r = rTrial;
+                sse = sseTrial;
+                if (options.damping == NielsenDamping) {
+                    // 秩一更新的 J 预测不准时 ρ 反映的是模型误差而非步长过大，此时不放大 λ (J 将重新差分)
+                    double t = 2.0 * info.rho - 1.0;
+                    double factor = std::max(1.0 / 3.0, 1.0 - t * t * t);
+                    if (fromFresh || factor < 1.0) lambda *= factor;
+                    nu = 2.0;
+                } else {
+                    lambda /= 10.0;
+                }
+                accepted = true;
+                info.stepNorm = s.norm();
+                info.geodesicUsed = geodesicUsed;
+                if (options.broyden) {
+                    H = J.transpose() * J;
+                    g = J.transpose() * r;
+                }
+                if (problem.accepted) problem.accepted(u, sse);
+
+                if (smallStep || reduction <= options.reductionTolerance) {
+                    // 秩一更新的 J 可能给出虚假的小步长: 先重新差分，下次迭代再判断
+                    if (fromFresh) {
+                        report.reason = smallStep ? SmallStep : SmallReduction;
+                        converged = true;
+                    } else {
+                        needRebuild = true;
+                    }
+                }
+                break;
+            }
+            if (!fresh) {
+                // 秩一更新后的 J 给出的步长被拒绝: 先在当前点重新差分，再以同样的 λ 重试
+                rebuild();
+                info.jacobianRebuilt = true;
+                continue;
+            }
+            if (options.damping == NielsenDamping) {
+                lambda *= nu;
+                nu *= 2.0;
+            } else {
+                lambda *= 10.0;
+            }
+        }
+
+        info.accepted = accepted;
+        info.sse = sse;
+        info.lambda = lambda;
+        info.evaluations = report.evaluations + report.jacobianEvaluations;
+        report.history.push_back(info);
+        report.iterations = iter + 1;
+        if (problem.iterationDone) problem.iterationDone(info);
+        if (converged) break;
+
+        if (!accepted) {
+            needRebuild = !fresh;
+            // 如果 lambda 过大仍无法下降，认为已陷入局部极小值，终止
+            if (lambda > 1e10) {
+                report.reason = NoProgress;
+                break;
+            }
+        }
+    }
+
+    report.u = u;
+    report.sse = sse;
+    report.evaluations += report.jacobianEvaluations;
+    return report;
+}
+
+void ModelFitter::samplingRange(const Eigen::VectorXd& u0, const Problem& problem, int j, double span,
+                                double& lo, double& hi)
+{
+    lo = j < problem.lower.size() ? problem.lower[j] : -HUGE_VAL;
+    hi = j < problem.upper.size() ? problem.upper[j] : HUGE_VAL;
+    if (!std::isfinite(lo)) lo = std::min(u0[j], std::isfinite(hi) ? hi : u0[j]) - span;
+    if (!std::isfinite(hi)) hi = std::max(u0[j], lo) + span;
+}
+
+std::vector<Eigen::VectorXd> ModelFitter::latinHypercube(const Eigen::VectorXd& u0, const Problem& problem, int count,
+                                                         unsigned int seed, double span)
+{
+    const int n = (int)u0.size();
+    std::vector<Eigen::VectorXd> points((size_t)std::max(count, 0), Eigen::VectorXd(n));
+    if (count <= 0) return points;
+
+    // 每个变量的 count 个分层各取一个点，分层顺序对各变量独立打乱
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> jitter(0.0, 1.0);
+    std::vector<int> perm((size_t)count);
+    for (int j = 0; j < n; ++j) {
+        double lo, hi;
+        samplingRange(u0, problem, j, span, lo, hi);
+        std::iota(perm.begin(), perm.end(), 0);
+        std::shuffle(perm.begin(), perm.end(), rng);
+        for (int i = 0; i < count; ++i) points[(size_t)i][j] = lo + (hi - lo) * (perm[(size_t)i] + jitter(rng)) / count;
+    }
+    return points;
+}
+
+ModelFitter::MultiStartReport ModelFitter::multiStart(const Eigen::VectorXd& u0, const Problem& problem,
+                                                      const MultiStartOptions& options)
+{
+    MultiStartReport result;
+    const int starts = std::max(options.starts, 1);
+    const int polish = std::max(1, std::min(options.polishCount, starts));
+
+    std::vector<Eigen::VectorXd> points = latinHypercube(u0, problem, starts, options.seed, options.defaultSpan);
+    if (options.includeInitial) points[0] = u0;
+
+    std::vector<Candidate> runs((size_t)starts);
+    for (int i = 0; i < starts; ++i) {
+        runs[(size_t)i].start = i;
+        runs[(size_t)i].u0 = clamp(points[(size_t)i], problem);
+        runs[(size_t)i].u = runs[(size_t)i].u0;
+    }
+
+    // 并行阶段不回调界面，只检查取消
+    Problem stage = problem;
+    stage.accepted = nullptr;
+    stage.iterationDone = nullptr;
+    const std::atomic<bool>* cancel = options.cancel;
+    stage.shouldContinue = [cancel](int) { return !(cancel && cancel->load()); };
+    auto cancelled = [cancel]() { return cancel && cancel->load(); };
+
+    // 下一轮的存活数: keepFraction 限制在 [0, 1] (非法值按 0)，每轮至少淘汰一个，且不少于精修数，
+    // 否则已收敛的起点不再迭代时筛选永远不结束
+    const double keepFraction = options.keepFraction > 0.0 ? std::min(options.keepFraction, 1.0) : 0.0;
+    auto survivors = [&](int alive) {
+        return std::max(polish, std::min(alive - 1, (int)std::ceil(alive * keepFraction)));
+    };
+
+    // 计划的 LM 段数: 各轮存活数之和 + 精修数 (已收敛的起点不再迭代，实际可能更少)
+    // (初值保留时最后一名让位给初值，存活数不变)
+    int total = 0;
+    for (int alive = starts; ; ) {
+        total += alive;
+        if (alive <= polish) break;
+        alive = survivors(alive);
+    }
+    total += polish;
+    std::atomic<int> done(0);
+
+    std::atomic<int> residualCount(0);
+    auto runSegment = [&](Candidate& c, int iterations) {
+        Options lm = options.lm;
+        lm.maxIterations = iterations;
+        Report report = levenbergMarquardt(c.u, stage, lm);
+        c.evaluations += report.evaluations;
+        c.iterations += report.iterations;
+        c.reason = report.reason;
+        if (report.reason == EvaluationFailed) {
+            c.sse = std::numeric_limits<double>::infinity();
+        } else {
+            c.u = report.u;
+            c.sse = report.sse;
+            residualCount.store(report.residualCount);
+        }
+        int d = ++done;
+        if (options.progress) options.progress(std::min(d, total), total);
+    };
+    // 本段停止原因说明已收敛或无法继续时，不再参加后续迭代
+    auto finished = [](const Candidate& c) {
+        return c.reason != MaxIterations && c.reason != Cancelled;
+    };
+    auto bySse = [&runs](int a, int b) {
+        const Candidate& x = runs[(size_t)a];
+        const Candidate& y = runs[(size_t)b];
+        return x.sse < y.sse || (x.sse == y.sse && x.start < y.start);
+    };
+
+    std::vector<int> alive((size_t)starts);
+    std::iota(alive.begin(), alive.end(), 0);
+
+    // 1. 筛选: 每轮各起点迭代 roundIterations 次，按误差保留前 keepFraction
+    while (!cancelled()) {
+        std::vector<int> active;
+        for (int i : alive) {
+            if (!finished(runs[(size_t)i]) || runs[(size_t)i].rounds == 0) active.push_back(i);
+        }
+        ModelThreadPool::instance().parallelFor((int)active.size(), options.threadCount, [&](int k) {
+            Candidate& c = runs[(size_t)active[(size_t)k]];
+            runSegment(c, options.roundIterations);
+            ++c.rounds;
+        });
+        std::stable_sort(alive.begin(), alive.end(), bySse);
+        if ((int)alive.size() <= polish) break;
+        // 初值 (表格中的当前参数) 不参与淘汰: 多起点的结果不应比只从初值迭代差
+        int keep = survivors((int)alive.size());
+        auto initial = std::find(alive.begin(), alive.end(), 0);
+        if (options.includeInitial && initial != alive.end() && initial - alive.begin() >= keep) {
+            std::rotate(alive.begin() + keep - 1, initial, initial + 1);
+        }
+        alive.resize((size_t)keep);
+    }
+
+    // 2. 精修: 最好的 polish 个起点完整迭代 (已收敛的起点同样再迭代一次，确认停止条件)
+    if (!cancelled()) {
+        alive.resize((size_t)std::min((int)alive.size(), polish));
+        ModelThreadPool::instance().parallelFor((int)alive.size(), options.threadCount, [&](int k) {
+            Candidate& c = runs[(size_t)alive[(size_t)k]];
+            if (std::isfinite(c.sse)) runSegment(c, options.lm.maxIterations);
+            c.polished = true;
+        });
+    }
+
+    std::vector<int> order((size_t)starts);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), bySse);
+    for (int i : order) {
+        result.evaluations += runs[(size_t)i].evaluations;
+        result.candidates.push_back(runs[(size_t)i]);
+    }
+    result.residualCount = residualCount.load();
+    result.cancelled = cancelled();
+    return result;
+}
+
+ModelFitter::EvolutionReport ModelFitter::differentialEvolution(const Eigen::VectorXd& u0, const Problem& problem,
+                                                                const EvolutionOptions& options)
+{
+    EvolutionReport report;
+    const int n = (int)u0.size();
+    const int np = options.populationSize > 0 ? std::max(options.populationSize, 4) : std::max(20, 10 * n);
+    report.populationSize = np;
+
+    Eigen::VectorXd lo(n), hi(n);
+    for (int j = 0; j < n; ++j) samplingRange(u0, problem, j, options.defaultSpan, lo[j], hi[j]);
+
+    std::vector<Eigen::VectorXd> pop = latinHypercube(u0, problem, np, options.seed, options.defaultSpan);
+    if (options.includeInitial) pop[0] = clamp(u0, problem);
+
+    // 并行计算一组个体的误差平方和 (失败为 +inf)
+    std::atomic<int> residualCount(0);
+    auto evaluateAll = [&](const std::vector<Eigen::VectorXd>& xs, std::vector<double>& costs) {
+        costs.assign(xs.size(), std::numeric_limits<double>::infinity());
+        ModelThreadPool::instance().parallelFor((int)xs.size(), options.threadCount, [&](int i) {
+            Eigen::VectorXd r;
+            if (problem.residuals(xs[(size_t)i], r) && r.size() > 0 && r.allFinite()) {
+                costs[(size_t)i] = r.squaredNorm();
+                residualCount.store((int)r.size());
+            }
+        });
+        report.evaluations += (long long)xs.size();
+    };
+    auto cancelled = [&options]() { return options.cancel && options.cancel->load(); };
+
+    std::vector<double> cost;
+    evaluateAll(pop, cost);
+    int best = (int)(std::min_element(cost.begin(), cost.end()) - cost.begin());
+
+    std::mt19937 rng(options.seed + 1u);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> pick(0, np - 1);
+    std::uniform_int_distribution<int> pickDim(0, std::max(n - 1, 0));
+    std::vector<Eigen::VectorXd> trials((size_t)np, Eigen::VectorXd(n));
+    std::vector<double> trialCost;
+    int stall = 0;
+
+    report.reason = MaxIterations;
+    int gen = 0;
+    for (; gen < options.maxGenerations; ++gen) {
+        if (cancelled()) {
+            report.reason = Cancelled;
+            break;
+        }
+        const int m = std::max(residualCount.load(), 1);
+        if (options.targetMSE > 0.0 && cost[(size_t)best] / m < options.targetMSE) {
+            report.reason = TargetReached;
+            break;
+        }
+
+        // 生成试验个体: v = x_r1 + F (x_r2 - x_r3)，按 CR 与父代交叉
+        const double F = 0.5 + 0.5 * unit(rng);
+        for (int i = 0; i < np; ++i) {
+            int r1, r2, r3;
+            do { r1 = pick(rng); } while (r1 == i);
+            do { r2 = pick(rng); } while (r2 == i || r2 == r1);
+            do { r3 = pick(rng); } while (r3 == i || r3 == r1 || r3 == r2);
+            const int jr = pickDim(rng);
+            Eigen::VectorXd& t = trials[(size_t)i];
+            for (int j = 0; j < n; ++j) {
+                if (j == jr || unit(rng) < options.crossover) {
+                    double v = pop[(size_t)r1][j] + F * (pop[(size_t)r2][j] - pop[(size_t)r3][j]);
+                    if (v < lo[j]) v = 0.5 * (pop[(size_t)i][j] + lo[j]);
+                    if (v > hi[j]) v = 0.5 * (pop[(size_t)i][j] + hi[j]);
+                    t[j] = v;
+                } else {
+                    t[j] = pop[(size_t)i][j];
+                }
+            }
+        }
+        evaluateAll(trials, trialCost);
+
+        // 一对一选择
+        const double previousBest = cost[(size_t)best];
+        for (int i = 0; i < np; ++i) {
+            if (trialCost[(size_t)i] <= cost[(size_t)i]) {
+                pop[(size_t)i] = trials[(size_t)i];
+                cost[(size_t)i] = trialCost[(size_t)i];
+                if (cost[(size_t)i] < cost[(size_t)best]) best = i;
+            }
+        }
+        const bool improved = cost[(size_t)best] < previousBest;
+        stall = improved ? 0 : stall + 1;
+        if (options.generationDone) options.generationDone(gen, pop[(size_t)best], cost[(size_t)best], improved);
+
+        // 收敛: 种群误差足够集中，或最好个体长期没有改进
+        double worst = 0.0;
+        for (double c : cost) {
+            if (std::isfinite(c)) worst = std::max(worst, c);
+        }
+        if ((worst - cost[(size_t)best]) <= options.spreadTolerance * cost[(size_t)best]
+            || stall >= options.stallGenerations) {
+            report.reason = SmallReduction;
+            ++gen;
+            break;
+        }
+    }
+
+    report.generations = gen;
+    report.u = pop[(size_t)best];
+    report.sse = cost[(size_t)best];
+    report.residualCount = residualCount.load();
+    return report;
+}
@@ -0,0 +1,227 @@
+/*
+ * 文件名: modelfitter.h
+ * 文件作用: 非线性最小二乘拟合算法头文件 (纯 C++ 实现，仅依赖 Eigen)
+ * 功能描述:
+ * 1. 在拟合变量的内部坐标 u 上最小化 ||r(u)||² (对数敏感参数取 log10，其余取原值，由调用方换算)，
+ *    u 受上下限约束 (越界分量截断到边界)。
+ * 2. 残差由调用方计算 (界面中经 ModelSolver 计算理论曲线)；雅可比矩阵各列的扰动点一次性批量交给调用方，
+ *    可并行计算。
+ * 3. Levenberg-Marquardt: 阻尼 λ(1 + |H_ii|) 加在 JᵀJ 对角线上 (矩阵均为 Eigen 连续存储)。λ 的更新可选
+ *    Marquardt (拒绝 ×10，接受 ÷10) 或 Nielsen (按实际/预测下降比 ρ 连续调整: 接受时
+ *    λ·max(1/3, 1-(2ρ-1)³)，连续拒绝时依次 ×2、×4、×8…)。
+ * 4. 可选 Broyden 秩一更新: 接受的步长 s 之后以 J += (Δr - J·s)·sᵀ / sᵀs 修正雅可比矩阵，不做差分；
+ *    每 rebuildInterval 次迭代、实际/预测下降比低于 rebuildRatio、或更新后的 J 给出的步长被拒绝时，
+ *    重新做完整差分。
+ * 5. 差分方式可选中心差分 (2n 次残差计算) 或前向差分 (n 次)，报告中统计各类残差计算次数。
+ * 6. 可选测地加速 (geodesic acceleration): 沿速度方向 v 多算一次残差估计二阶方向导数 r''，
+ *    求加速度 a = -(H + λD)⁻¹ Jᵀr''，2|a|/|v| 不超过 geodesicRatio 时步长取 v + a/2。
+ * 7. 停止判据: 均方误差低于 targetMSE、梯度 |Jᵀr|∞ 低于 gradientTolerance、接受步长的相对大小低于
+ *    stepTolerance、误差平方和的相对下降低于 reductionTolerance (后两者只对完整差分 J 给出的步长生效，
+ *    秩一更新的 J 先重新差分再判断)。每次迭代的诊断信息记入报告并可经回调实时取得。
+ * 8. 多起点拟合: 在上下限内 (即对数参数的对数空间) 拉丁超立方抽取起点，各起点并行运行少量 LM 迭代，
+ *    每轮按误差保留较好的一部分继续迭代，最后对最好的几个完整迭代 (精修)，按误差排序返回全部候选解。
+ * 9. 差分进化 (DE/rand/1/bin，F 每代在 [0.5, 1) 内随机抖动): 初始种群在上下限内拉丁超立方抽样，
+ *    每代试验个体先按固定种子顺序生成，再并行计算残差，越界分量取父代与边界的中点。
+ *    用于对初值不敏感的全局搜索，最好的个体再交给 LM 精修 (由调用方完成)。
+ */
+
+#ifndef MODELFITTER_H
+#define MODELFITTER_H
+
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <Eigen/Dense>
+
+class ModelFitter
+{
+public:
+    enum JacobianMode {
+        CentralDifference = 0,  // (r(u+h) - r(u-h)) / 2h
+        ForwardDifference       // (r(u+h) - r(u)) / h
+    };
+
+    enum StopReason {
+        TargetReached = 0,      // 均方误差低于 targetMSE
+        MaxIterations,          // 达到迭代次数上限
+        NoProgress,             // λ 过大仍无法下降
+        Cancelled,              // 调用方要求停止
+        EvaluationFailed,       // 初始点的残差无法计算
+        SmallGradient,          // 梯度足够小
+        SmallStep,              // 步长相对参数足够小
+        SmallReduction          // 误差平方和的相对下降足够小
+    };
+
+    enum DampingUpdate {
+        MarquardtDamping = 0,   // 拒绝 ×10，接受 ÷10
+        NielsenDamping          // 按下降比 ρ 连续调整
+    };
+
+    // 单次迭代的诊断信息
+    struct Iteration
+    {
+        int iteration = 0;
+        double sse = 0.0;               // 迭代结束时的误差平方和
+        double lambda = 0.0;            // 迭代结束时的阻尼因子
+        double gradientNorm = 0.0;      // 迭代开始时 |Jᵀr|∞
+        double stepNorm = 0.0;          // 接受步长的 2-范数 (未接受为 0)
+        double rho = 0.0;               // 最后一次试探步的实际/预测下降比
+        int trials = 0;                 // 试探步个数
+        bool accepted = false;
+        bool jacobianRebuilt = false;   // 本次迭代是否做了完整差分
+        bool geodesicUsed = false;      // 接受的步长是否包含加速度项
+        long long evaluations = 0;      // 截至本次迭代的残差计算总次数
+    };
+
+    struct Problem
+    {
+        // 计算 u 处的残差，失败时返回 false (该试探点视为误差无穷大)
+        std::function<bool(const Eigen::VectorXd& u, Eigen::VectorXd& r)> residuals;
+        // 可选: 批量计算多个点的残差 (rs 预先分配为 us.size()，失败的点留空)，未给出时逐点调用 residuals
+        std::function<void(const std::vector<Eigen::VectorXd>& us, std::vector<Eigen::VectorXd>& rs)> batchResiduals;
+        // 可选: 每次迭代开始时调用，返回 false 时停止
+        std::function<bool(int iteration)> shouldContinue;
+        // 可选: 每次接受新点后调用
+        std::function<void(const Eigen::VectorXd& u, double sse)> accepted;
+        // 可选: 每次迭代结束时调用
+        std::function<void(const Iteration& info)> iterationDone;
+
+        Eigen::VectorXd lower;      // u 的下限 (可为 -inf)
+        Eigen::VectorXd upper;      // u 的上限 (可为 +inf)
+        Eigen::VectorXd steps;      // 各变量的差分步长
+    };
+
+    struct Options
+    {
+        int maxIterations = 50;
+        int maxRetries = 5;             // 每次迭代内试探步的最多次数
+        double initialLambda = 0.01;
+        DampingUpdate damping = NielsenDamping;
+        bool geodesic = false;          // 测地加速 (每个试探步多一次残差计算)
+        double geodesicStep = 0.1;      // 估计 r'' 的差分步长 (相对速度 v)
+        double geodesicRatio = 0.75;    // 允许的 2|a|/|v| 上限
+        double targetMSE = 3e-3;        // sse / 残差个数 低于该值时停止 (<=0 不使用)
+        double gradientTolerance = 1e-8;    // |Jᵀr|∞ 低于该值时停止
+        double stepTolerance = 1e-6;        // |s| <= tol·(|u| + tol) 时停止
+        double reductionTolerance = 1e-6;   // (sse - sse') / sse 低于该值时停止
+        JacobianMode jacobian = CentralDifference;
+        bool broyden = false;
+        int rebuildInterval = 5;        // Broyden 模式下完整差分的最大间隔 (迭代次数)
+        double rebuildRatio = 0.25;     // 实际/预测下降比低于该值时下一次迭代重新差分
+    };
+
+    struct Report
+    {
+        Eigen::VectorXd u;              // 最终参数
+        double sse = 0.0;
+        int residualCount = 0;
+        int iterations = 0;
+        StopReason reason = MaxIterations;
+        long long evaluations = 0;      // 残差计算总次数 (= 试探点 + 差分点 + 测地加速点 + 初始点)
+        long long jacobianEvaluations = 0; // 其中差分使用的次数
+        int jacobianBuilds = 0;         // 完整差分次数
+        int broydenUpdates = 0;         // 秩一更新次数
+        long long geodesicEvaluations = 0; // 其中测地加速使用的次数
+        std::vector<Iteration> history; // 各次迭代的诊断信息
+    };
+
+    struct MultiStartOptions
+    {
+        int starts = 16;                // 起点个数 (含初值)
+        unsigned int seed = 1;          // 拉丁超立方随机种子
+        bool includeInitial = true;     // 第一个起点取 u0 (不参与淘汰)
+        double defaultSpan = 2.0;       // 上下限为无穷时在 u0 两侧的抽样宽度
+        int roundIterations = 4;        // 筛选阶段每轮的迭代次数
+        double keepFraction = 0.5;      // 每轮保留的比例 (限制在 [0, 1]，每轮至少淘汰一个，不少于 polishCount)
+        int polishCount = 3;            // 完整迭代的候选个数
+        int threadCount = 0;            // 同时运行的起点数，<=0 表示全部核心
+        Options lm;                     // LM 设置 (精修使用其 maxIterations)
+        const std::atomic<bool>* cancel = nullptr;  // 非空且为真时在当前迭代后停止
+        std::function<void(int done, int total)> progress; // 每完成一段 LM 调用一次 (可能在工作线程中)
+    };
+
+    struct Candidate
+    {
+        int start = 0;                  // 起点序号 (includeInitial 时 0 为初值)
+        Eigen::VectorXd u0;             // 起点
+        Eigen::VectorXd u;              // 终点
+        double sse = 0.0;               // 终点误差平方和 (起点无法计算时为 +inf)
+        int iterations = 0;             // 累计迭代次数
+        long long evaluations = 0;      // 累计残差计算次数
+        int rounds = 0;                 // 参与的筛选轮数 (被淘汰前)
+        bool polished = false;          // 是否经过完整迭代
+        StopReason reason = MaxIterations; // 最后一段 LM 的停止原因
+    };
+
+    struct MultiStartReport
+    {
+        std::vector<Candidate> candidates;  // 按 sse 从小到大排序
+        int residualCount = 0;
+        long long evaluations = 0;
+        bool cancelled = false;
+    };
+
+    struct EvolutionOptions
+    {
+        int populationSize = 0;         // <=0 时取 max(20, 10·变量数)
+        int maxGenerations = 150;
+        double crossover = 0.9;         // 交叉概率 CR
+        unsigned int seed = 1;
+        bool includeInitial = true;     // 初始种群包含 u0
+        double defaultSpan = 2.0;       // 上下限为无穷时在 u0 两侧的抽样宽度
+        double targetMSE = 0.0;         // 最好个体的 sse / 残差个数 低于该值时停止 (<=0 不使用)
+        double spreadTolerance = 1e-3;  // 种群误差的 (最大 - 最小) / 最小 低于该值时停止
+        int stallGenerations = 30;      // 最好个体连续若干代没有改进时停止
+        int threadCount = 0;            // 并行计算个体数，<=0 表示全部核心
+        const std::atomic<bool>* cancel = nullptr;
+        // 每代结束后在调用线程回调 (improved: 最好个体本代是否改进)
+        std::function<void(int generation, const Eigen::VectorXd& best, double sse, bool improved)> generationDone;
+    };
+
+    struct EvolutionReport
+    {
+        Eigen::VectorXd u;              // 最好个体
+        double sse = 0.0;
+        int residualCount = 0;
+        int populationSize = 0;
+        int generations = 0;
+        long long evaluations = 0;
+        StopReason reason = MaxIterations;  // TargetReached / MaxIterations / SmallReduction (收敛或停滞) / Cancelled
+    };
+
+    static Report levenbergMarquardt(const Eigen::VectorXd& u0, const Problem& problem, const Options& options);
+
+    // 差分进化。个体并行计算 problem.residuals (须可重入)，problem 的其他回调不调用
+    static EvolutionReport differentialEvolution(const Eigen::VectorXd& u0, const Problem& problem,
+                                                 const EvolutionOptions& options);
+
+    // 多起点拟合。各起点并行运行，problem 的 accepted、iterationDone、shouldContinue 回调不调用，
+    // 取消经 options.cancel；residuals 与 batchResiduals 须可重入
+    static MultiStartReport multiStart(const Eigen::VectorXd& u0, const Problem& problem,
+                                       const MultiStartOptions& options);
+
+    // 第 j 个变量的有限抽样范围 (无穷边界取 u0 ± span)
+    static void samplingRange(const Eigen::VectorXd& u0, const Problem& problem, int j, double span,
+                              double& lo, double& hi);
+
+    // 在 [lower, upper] 内拉丁超立方抽取 count 个点 (无穷边界取 u0 ± span)
+    static std::vector<Eigen::VectorXd> latinHypercube(const Eigen::VectorXd& u0, const Problem& problem, int count,
+                                                       unsigned int seed, double span);
+
+    // 差分雅可比矩阵 (r 为 u 处的残差)，evaluations 累加残差计算次数
+    static Eigen::MatrixXd finiteDifferenceJacobian(const Eigen::VectorXd& u, const Eigen::VectorXd& r,
+                                                    const Problem& problem, JacobianMode mode,
+                                                    long long* evaluations = nullptr);
+
+    // 停止原因的简短英文名称 (日志与基准程序输出)
+    static const char* reasonName(StopReason reason);
+
+    // 把 u 截断到 [lower, upper]
+    static Eigen::VectorXd clamp(const Eigen::VectorXd& u, const Problem& problem);
+
+    // 批量计算残差 (problem.batchResiduals 或逐点)，返回各点是否成功 (长度为 expectedSize 且全部有限)
+    static std::vector<bool> evaluate(const Problem& problem, const std::vector<Eigen::VectorXd>& us,
+                                      std::vector<Eigen::VectorXd>& rs, int expectedSize);
+};
+
+#endif // MODELFITTER_H
@@ -0,0 +1,69 @@
+/*
+ * 文件名: modelinversion.h
+ * 文件作用: 拉普拉斯数值反演算法头文件 (纯 C++ 实现，无 Qt 依赖)
+ * 功能描述:
+ * 1. 提供四种反演算法: Stehfest (实轴)、固定 Talbot、de Hoog (商差分连分式加速)、Euler 求和 (Abate-Whitt)。
+ * 2. 每种算法拆分为 "生成节点" 与 "组合节点值" 两步，调用方可以先并行计算全部节点上的拉普拉斯值再组合。
+ * 3. 每次反演返回结果、误差估计与拉普拉斯函数计算次数，便于按精度要求选择代价最小的算法。
+ * 4. 误差估计均由已有节点值得到，不需要额外的拉普拉斯计算:
+ *    Stehfest 比较 N 与 N-2 项 (节点嵌套)；Talbot 比较嵌套的 M、M/2、M/4 点梯形公式并外推；
+ *    de Hoog 比较相邻两个连分式渐近值；Euler 比较相邻两个 Euler 加权和。
+ * 5. 提供与 Stehfest 节点对齐的时间网格 t = 2^(k/q)：相隔 q 个点的时间恰为 2 倍，(m, t) 与 (2m, 2t) 的节点
+ *    逐位相同，一条曲线约一半的拉普拉斯值可以复用。
+ */
+
+#ifndef MODELINVERSION_H
+#define MODELINVERSION_H
+
+#include <complex>
+#include <functional>
+#include <vector>
+
+class ModelInversion
+{
+public:
+    enum Method {
+        Stehfest = 0,   // 实轴 Stehfest，阶数为 N (偶数)
+        Talbot,         // 固定 Talbot 围道，阶数为节点数 M
+        DeHoog,         // de Hoog 商差分算法，阶数为 M (2M+1 个节点)
+        Euler           // Euler 求和，阶数为级数项数 n (另加 11 项二项式平均)
+    };
+
+    struct Result
+    {
+        double value = 0.0;         // f(t)
+        double errorEstimate = 0.0; // 绝对误差估计
+        int evaluations = 0;        // 拉普拉斯函数计算次数
+    };
+
+    static const char* methodName(Method method);
+
+    // 默认阶数 (highPrecision 为 false 时用于拟合迭代等低精度场合)
+    static int defaultOrder(Method method, bool highPrecision);
+
+    // 将阶数规范化为算法要求的取值 (如 Stehfest/Talbot 需要偶数)
+    static int normalizeOrder(Method method, int order);
+
+    // 反演一个时间点所需的拉普拉斯值个数
+    static int nodeCount(Method method, int order);
+
+    // 是否需要复数拉普拉斯变量 (Stehfest 只在正实轴上取值)
+    static bool isComplex(Method method);
+
+    // 生成时间 t 对应的拉普拉斯变量 s[0 .. nodeCount)
+    static void nodes(Method method, int order, double t, std::complex<double>* s);
+
+    // 由节点上的拉普拉斯值 F[0 .. nodeCount) 组合出 f(t)
+    static Result combine(Method method, int order, double t, const std::complex<double>* F);
+
+    // 与 Stehfest 节点对齐的对数时间网格: 共 count 个点，两端恰为 10^startExp 与 10^endExp，
+    // 内点取均匀对数网格上最近的格点 t = 2^(k/q) (q 为不少于均匀网格密度的每倍程点数)。
+    // 相隔 q 个格点的时间比值恰为 2，网格乘以任意常数 (如换算为无因次时间) 后节点仍逐位重合
+    static std::vector<double> alignedTimes(int count, double startExp, double endExp);
+
+    // 便捷接口: 串行计算节点值并组合
+    static Result invert(Method method, int order, double t,
+                         const std::function<std::complex<double>(std::complex<double>)>& F);
+};
+
+#endif // MODELINVERSION_H
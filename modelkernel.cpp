@@ -0,0 +1,730 @@
+/*
+ * 文件名: modelkernel.cpp
+ * 文件作用: 压裂水平井复合页岩油模型计算内核实现
+ * 功能描述:
+ * 1. 实现 PWD_composite 核心数学模型 (无限大/封闭/定压三类外边界)。
+ * 2. 实现复合模型拉普拉斯空间解及变井储/表皮修正。
+ * 3. 实现数值反演 (Stehfest/Talbot/de Hoog/Euler，见 modelinversion) 和应力敏感修正，反演的 (t, 节点) 组合可分配到线程池并行计算。
+ * 4. 同一直线上的线源积分扣除 K0 的对数奇异性后使用定阶 Gauss-Legendre 积分，计算量有确定上界。
+ * 5. 贝塞尔函数统一使用 modelbessel 的指数缩放批量实现，积分节点整批计算。
+ * 6. 所有函数均为静态函数，只读取传入的 ModelContext，不依赖任何界面对象。
+ * 7. 拉普拉斯空间解按 T = double / std::complex<double> 模板实现，实数版本保持原有的批量 SIMD 路径。
+ * 8. 对数导数 tD·dpD/dtD 由同一组节点值乘以 s 后反演 (L{dp/dt} = s·p̄)，不做数值微分。
+ * 9. 拉普拉斯空间解分为储层响应 PWD(z) 与井储/表皮外层修正两层，ctx.cacheResponse 时储层响应经
+ *    ModelResponseCache 复用 (见 modelresponsecache.h)。
+ * 10. 裂缝系统利用加边结构只对 nf×nf 影响矩阵消元一次；nf <= MaxStackFractures 时全部工作数组在栈上，
+ *     单次拉普拉斯计算不分配堆内存。
+ * 11. nf 较大时 (均匀布缝) 不装配 nf×nf 矩阵: 影响系数只取第一列 (nf 个积分，远场可降阶)，
+ *     以 FFT Toeplitz 乘积 + T. Chan 循环预条件 GMRES 求 G·y = 1；不收敛时回到直接消元。
+ * 12. 一条曲线的 Stehfest 节点按数值去重，公比为 2 的整数次方根的时间网格 (见 ModelSolver::generateAlignedTimeSteps)
+ *     上约一半的节点重合，每个不同的 z 只计算一次。
+ * 13. 批量拉普拉斯接口: 模型分派、裂缝布置、M12 等准备工作每批只做一次，各 z 并行计算；
+ *     反演 (以及经 ModelSolver 调用的拟合、敏感性分析) 全部走批量路径，单点接口只是同一实现的一次调用。
+ */
+
+#include "modelkernel.h"
+#include "modelthreadpool.h"
+#include "modelquadrature.h"
+#include "modelbessel.h"
+#include "modelresponsecache.h"
+#include "modeltoeplitz.h"
+
+#include <cmath>
+#include <complex>
+#include <algorithm>
+#include <type_traits>
+#include <unordered_map>
+
+bool ModelKernel::hasStorage(ModelType type)
+{
+    return (type == Model_1 || type == Model_3 || type == Model_5);
+}
+
+bool ModelKernel::isInfinite(ModelType type)
+{
+    return (type == Model_1 || type == Model_2);
+}
+
+bool ModelKernel::isClosed(ModelType type)
+{
+    return (type == Model_3 || type == Model_4);
+}
+
+bool ModelKernel::isConstPressure(ModelType type)
+{
+    return (type == Model_5 || type == Model_6);
+}
+
+ModelKernel::BoundaryKind ModelKernel::boundaryKind(ModelType type)
+{
+    if (isInfinite(type)) return InfiniteBoundary;
+    return isClosed(type) ? ClosedBoundary : ConstPressureBoundary;
+}
+
+struct ModelKernel::NodeBatch
+{
+    int count = 0;                       // 不同节点的个数
+    bool complexNodes = false;           // 节点是否为复数
+    const std::complex<double>* s = nullptr;     // 不同节点 (count 个)
+    const char* found = nullptr;         // 非空时: 该节点的 PWD 已由缓存给出
+    std::complex<double>* pwd = nullptr; // 非空时: 读取缓存值 / 写出新算的 PWD
+    std::complex<double>* values = nullptr;      // 输出: 拉普拉斯空间值
+};
+
+// 裂缝布置与只依赖参数的储层常数: 每次公开接口调用 (或每批 z) 只准备一次，
+// nf <= MaxStackFractures 时裂缝位置在栈上
+struct ModelKernel::FractureLayout
+{
+    int nf = 1;
+    double M12 = 1.0;
+    double fs2 = 0.0;
+    const double* xwD = nullptr;
+
+    explicit FractureLayout(const ModelContext& ctx)
+    {
+        nf = std::max(ctx.nf, 1);
+        M12 = ctx.kf / ctx.km;
+        fs2 = M12 * ctx.omega2;
+        double* xw = xwStack;
+        if (nf > MaxStackFractures) { xwHeap.resize(nf); xw = xwHeap.data(); }
+        if (nf == 1) { xw[0] = 0.0; } else {
+            double start = -0.9; double end = 0.9; double step = (end - start) / (nf - 1);
+            for (int i = 0; i < nf; ++i) xw[i] = start + i * step;
+        }
+        xwD = xw;
+    }
+    FractureLayout(const FractureLayout&) = delete;
+    FractureLayout& operator=(const FractureLayout&) = delete;
+
+private:
+    double xwStack[MaxStackFractures];
+    std::vector<double> xwHeap;
+};
+
+namespace {
+
+typedef std::complex<double> cplx;
+
+// 模型类型 -> (外边界, 是否变井储) 的编译期标签，f 以两个标签调用一次
+typedef std::integral_constant<int, ModelKernel::InfiniteBoundary> InfiniteTag;
+typedef std::integral_constant<int, ModelKernel::ClosedBoundary> ClosedTag;
+typedef std::integral_constant<int, ModelKernel::ConstPressureBoundary> ConstPressureTag;
+
+template<class F>
+auto dispatchModel(ModelKernel::ModelType type, F&& f) -> decltype(f(InfiniteTag(), std::true_type()))
+{
+    switch (type) {
+    case ModelKernel::Model_1: return f(InfiniteTag(), std::true_type());
+    case ModelKernel::Model_2: return f(InfiniteTag(), std::false_type());
+    case ModelKernel::Model_3: return f(ClosedTag(), std::true_type());
+    case ModelKernel::Model_4: return f(ClosedTag(), std::false_type());
+    case ModelKernel::Model_5: return f(ConstPressureTag(), std::true_type());
+    case ModelKernel::Model_6: return f(ConstPressureTag(), std::false_type());
+    }
+    return f(InfiniteTag(), std::true_type());
+}
+
+template<class F>
+auto dispatchBoundary(ModelKernel::ModelType type, F&& f) -> decltype(f(InfiniteTag()))
+{
+    switch (ModelKernel::boundaryKind(type)) {
+    case ModelKernel::InfiniteBoundary: return f(InfiniteTag());
+    case ModelKernel::ClosedBoundary: return f(ClosedTag());
+    case ModelKernel::ConstPressureBoundary: return f(ConstPressureTag());
+    }
+    return f(InfiniteTag());
+}
+
+inline double realPart(double x) { return x; }
+inline double realPart(const cplx& x) { return x.real(); }
+
+// 解 G·y = 1 (G 为 n×n 行主序，就地做部分选主元高斯消元)，返回 Σ y_i
+// 裂缝系统 [G, -1; z·1ᵀ, 0]·[q; pw] = [0; 1] 的加边结构给出 q = pw·G⁻¹1，pw = 1 / (z·1ᵀG⁻¹1)，
+// 因此只需对 G 消元一次，不必分解 (n+1)×(n+1) 的加边矩阵
+template<class T>
+T solveUnitSum(T* G, T* y, int n)
+{
+    for (int i = 0; i < n; ++i) y[i] = 1.0;
+    for (int k = 0; k < n; ++k) {
+        int p = k;
+        double best = std::abs(G[k * n + k]);
+        for (int i = k + 1; i < n; ++i) {
+            double v = std::abs(G[i * n + k]);
+            if (v > best) { best = v; p = i; }
+        }
+        if (p != k) {
+            for (int j = k; j < n; ++j) std::swap(G[k * n + j], G[p * n + j]);
+            std::swap(y[k], y[p]);
+        }
+        T inv = T(1.0) / G[k * n + k];
+        for (int i = k + 1; i < n; ++i) {
+            T f = G[i * n + k] * inv;
+            if (f == T(0.0)) continue;
+            for (int j = k + 1; j < n; ++j) G[i * n + j] -= f * G[k * n + j];
+            y[i] -= f * y[k];
+        }
+    }
+    T sum = 0.0;
+    for (int i = n - 1; i >= 0; --i) {
+        T v = y[i];
+        for (int j = i + 1; j < n; ++j) v -= G[i * n + j] * y[j];
+        y[i] = v / G[i * n + i];
+        sum += y[i];
+    }
+    return sum;
+}
+
+// 复宗量时 |Ac·I0(γu)·e^(-γ rmD)| 小于该值 (取对数) 的积分点跳过 I0 计算
+const double NegligibleLog = -41.4;   // ln(1e-18)
+
+// 边界项贝塞尔函数 (指数缩放) 及 e^-x: 实宗量整批 SIMD 计算
+void boundaryBessel(const double* x, int n, double* k0, double* k1, double* i0, double* i1, double* expNeg)
+{
+    double negArgs[8];
+    for (int k = 0; k < n; ++k) negArgs[k] = -x[k];
+    ModelBessel::expArray(negArgs, expNeg, n);
+    ModelBessel::k0eArray(x, k0, n);
+    ModelBessel::k1eArray(x, k1, n);
+    ModelBessel::i0eArray(x, i0, n);
+    ModelBessel::i1eArray(x, i1, n);
+}
+
+// 复宗量逐个计算
+void boundaryBessel(const cplx* x, int n, cplx* k0, cplx* k1, cplx* i0, cplx* i1, cplx* expNeg)
+{
+    for (int k = 0; k < n; ++k) {
+        ModelBessel::scaledBesselKI(x[k], k0[k], k1[k], i0[k], i1[k]);
+        expNeg[k] = std::exp(-x[k]);
+    }
+}
+
+// 线源被积函数 (批量): out = Ac·I0(γu)·e^(-γ rmD) [+ K0(γu)]
+// 按 MaxBatch 分块处理，n 超过缓冲区长度时也不越界
+void lineSourceBatch(const double* u, double* out, int n, double gama1, double Ac_prefactor, double arg_g1_rm, bool withK0)
+{
+    using ModelQuadrature::MaxBatch;
+    double x[MaxBatch], e[MaxBatch], bes[MaxBatch];
+    for (int off = 0; off < n; off += MaxBatch) {
+        const int m = std::min(n - off, MaxBatch);
+        const double* uc = u + off;
+        double* oc = out + off;
+        for (int k = 0; k < m; ++k) { x[k] = gama1 * uc[k]; e[k] = x[k] - arg_g1_rm; }
+        ModelBessel::i0eArray(x, bes, m);
+        ModelBessel::expArray(e, oc, m);
+        for (int k = 0; k < m; ++k) oc[k] = (e[k] > -700.0) ? Ac_prefactor * bes[k] * oc[k] : 0.0;
+        if (withK0) {
+            for (int k = 0; k < m; ++k) e[k] = -x[k];
+            ModelBessel::k0eArray(x, bes, m);
+            ModelBessel::expArray(e, e, m);
+            for (int k = 0; k < m; ++k) oc[k] += bes[k] * e[k];
+        }
+    }
+}
+
+// 复宗量逐点计算，I0 项可忽略的点不计算 I0 (其连分式代价高于 K0)
+void lineSourceBatch(const double* u, cplx* out, int n, cplx gama1, cplx Ac_prefactor, cplx arg_g1_rm, bool withK0)
+{
+    double logAc = std::log(std::abs(Ac_prefactor));
+    for (int k = 0; k < n; ++k) {
+        cplx x = gama1 * u[k];
+        cplx e = x - arg_g1_rm;
+        bool needI = e.real() > -700.0 && logAc + e.real() > NegligibleLog;
+        cplx v(0.0);
+        if (needI && withK0) {
+            cplx k0, k1, i0, i1;
+            ModelBessel::scaledBesselKI(x, k0, k1, i0, i1);
+            v = Ac_prefactor * i0 * std::exp(e) + k0 * std::exp(-x);
+        } else if (needI) {
+            v = Ac_prefactor * ModelBessel::i0e(x) * std::exp(e);
+        } else if (withK0) {
+            v = ModelBessel::k0e(x) * std::exp(-x);
+        }
+        out[k] = v;
+    }
+}
+
+} // namespace
+
+void ModelKernel::calculatePD(const std::vector<double>& tD, const ModelContext& ctx, std::vector<double>& outPD,
+                              InversionReport* report)
+{
+    invertCurve(tD, ctx, outPD, nullptr, report);
+}
+
+void ModelKernel::calculatePDAndDerivative(const std::vector<double>& tD, const ModelContext& ctx,
+                                           std::vector<double>& outPD, std::vector<double>& outDeriv,
+                                           InversionReport* report)
+{
+    invertCurve(tD, ctx, outPD, &outDeriv, report);
+}
+
+void ModelKernel::invertCurve(const std::vector<double>& tD, const ModelContext& ctx, std::vector<double>& outPD,
+                              std::vector<double>* outDeriv, InversionReport* report)
+{
+    int numPoints = (int)tD.size();
+    outPD.assign(numPoints, 0.0);
+    if (outDeriv) outDeriv->assign(numPoints, 0.0);
+
+    ModelInversion::Method method = ctx.inversionMethod;
+    int order;
+    if (method == ModelInversion::Stehfest) {
+        order = ctx.stehfestN;
+        if (order % 2 != 0) order = 4;
+    } else {
+        order = ctx.inversionOrder > 0 ? ctx.inversionOrder : ModelInversion::defaultOrder(method, true);
+        order = ModelInversion::normalizeOrder(method, order);
+    }
+    int nodes = ModelInversion::nodeCount(method, order);
+    bool complexNodes = ModelInversion::isComplex(method);
+
+    // 1. 生成各时间点的拉普拉斯变量。Stehfest 节点 z = m·ln2/t 在公比为 2 (或 2 的整数次方根) 的时间网格上
+    //    大量重合 ((m, t) 与 (2m, 2t))，按数值去重后每个不同的 z 只计算一次；只有逐位相同的节点才合并，
+    //    结果与不去重逐位一致。其余算法的围道节点互不重合，不做去重
+    int total = numPoints * nodes;
+    std::vector<cplx> sNodes((size_t)total);
+    for (int k = 0; k < numPoints; ++k) {
+        if (tD[k] > 1e-12) ModelInversion::nodes(method, order, tD[k], &sNodes[(size_t)k * nodes]);
+    }
+    std::vector<int> slot((size_t)total, -1);
+    std::vector<cplx> uniqueNodes;
+    uniqueNodes.reserve(total);
+    if (method == ModelInversion::Stehfest) {
+        std::unordered_map<double, int> index;
+        index.reserve(total);
+        for (int idx = 0; idx < total; ++idx) {
+            if (tD[idx / nodes] <= 1e-12) continue;
+            auto it = index.emplace(sNodes[idx].real(), (int)uniqueNodes.size());
+            if (it.second) uniqueNodes.push_back(sNodes[idx]);
+            slot[idx] = it.first->second;
+        }
+    } else {
+        for (int idx = 0; idx < total; ++idx) {
+            if (tD[idx / nodes] <= 1e-12) continue;
+            slot[idx] = (int)uniqueNodes.size();
+            uniqueNodes.push_back(sNodes[idx]);
+        }
+    }
+    int count = (int)uniqueNodes.size();
+
+    // 2. 整批计算各不同节点的拉普拉斯空间值
+    std::vector<cplx> laplaceValues((size_t)count, cplx(0.0));
+    int fresh = evaluateLaplace(uniqueNodes.data(), count, complexNodes, ctx, laplaceValues.data());
+
+    // 3. 按固定顺序组合，保证结果与线程数无关
+    if (report) {
+        report->errorEstimate.assign(numPoints, 0.0);
+        report->derivativeErrorEstimate.assign(outDeriv ? numPoints : 0, 0.0);
+        report->evaluations = 0;
+        report->laplaceEvaluations = fresh;
+        report->maxErrorEstimate = 0.0;
+    }
+    std::vector<cplx> pointValues(nodes), scaledValues(outDeriv ? nodes : 0);
+    for (int k = 0; k < numPoints; ++k) {
+        double t = tD[k];
+        if (t <= 1e-12) { outPD[k] = 0; continue; }
+        for (int j = 0; j < nodes; ++j) pointValues[j] = laplaceValues[slot[(size_t)k * nodes + j]];
+        const cplx* F = pointValues.data();
+        ModelInversion::Result r = ModelInversion::combine(method, order, t, F);
+        outPD[k] = r.value;
+        double err = r.errorEstimate;
+
+        // t·dp/dt: 对 s·p̄(s) 反演后乘以 t
+        ModelInversion::Result rd;
+        if (outDeriv) {
+            const cplx* s = &sNodes[(size_t)k * nodes];
+            for (int j = 0; j < nodes; ++j) scaledValues[j] = s[j] * F[j];
+            rd = ModelInversion::combine(method, order, t, scaledValues.data());
+            (*outDeriv)[k] = t * rd.value;
+            rd.errorEstimate *= t;
+        }
+
+        if (std::abs(ctx.gamaD) > 1e-9) {
+            double arg = 1.0 - ctx.gamaD * outPD[k];
+            if (arg > 1e-12) {
+                outPD[k] = -1.0 / ctx.gamaD * std::log(arg);
+                // d(-ln(1-γp)/γ)/dp = 1/(1-γp)，误差与导数均按此比例缩放
+                err /= arg;
+                if (outDeriv) { (*outDeriv)[k] /= arg; rd.errorEstimate /= arg; }
+            }
+        }
+        if (report) {
+            report->errorEstimate[k] = err;
+            report->evaluations += r.evaluations;
+            report->maxErrorEstimate = std::max(report->maxErrorEstimate, err);
+            if (outDeriv) report->derivativeErrorEstimate[k] = rd.errorEstimate;
+        }
+    }
+}
+
+int ModelKernel::evaluateLaplace(const std::complex<double>* s, int count, bool complexNodes, const ModelContext& ctx,
+                                 std::complex<double>* values)
+{
+    if (count <= 0) return 0;
+    // 储层响应缓存: 已有的 PWD(z) 只重算井储/表皮外层，新算的 PWD(z) 在并行阶段结束后整批写回
+    std::shared_ptr<ModelResponseCache::Table> table;
+    if (ctx.cacheResponse) table = ModelResponseCache::table(ctx);
+    std::vector<cplx> pwdValues(table ? count : 0);
+    std::vector<char> active(table ? count : 0, 1), found(table ? count : 0);
+    if (table) table->lookup(s, count, active.data(), pwdValues.data(), found.data());
+
+    NodeBatch batch;
+    batch.count = count;
+    batch.complexNodes = complexNodes;
+    batch.s = s;
+    batch.found = table ? found.data() : nullptr;
+    batch.pwd = table ? pwdValues.data() : nullptr;
+    batch.values = values;
+    dispatchModel(ctx.type, [&](auto boundary, auto storage) {
+        evaluateNodes<decltype(boundary)::value, decltype(storage)::value>(batch, ctx);
+    });
+    int fresh = count;
+    if (table) {
+        for (int i = 0; i < count; ++i) { active[i] = !found[i]; fresh -= found[i] ? 1 : 0; }
+        table->insert(s, count, active.data(), pwdValues.data());
+    }
+    return fresh;
+}
+
+template<int Boundary, bool Storage>
+void ModelKernel::evaluateNodes(const NodeBatch& batch, const ModelContext& ctx)
+{
+    // 裂缝布置、M12 等只依赖参数的量整批只准备一次，各节点并行计算 (非有限值由反演组合时按 0 处理)
+    const FractureLayout layout(ctx);
+    ModelThreadPool::instance().parallelFor(batch.count, ctx.threadCount, [&](int idx) {
+        bool cached = batch.found && batch.found[idx];
+        if (batch.complexNodes) {
+            cplx z = batch.s[idx];
+            cplx pwd = cached ? batch.pwd[idx] : reservoirResponse<cplx, Boundary>(z, ctx, layout);
+            if (batch.pwd) batch.pwd[idx] = pwd;
+            batch.values[idx] = wellboreWrap<cplx, Storage>(z, pwd, ctx);
+        } else {
+            double z = batch.s[idx].real();
+            double pwd = cached ? batch.pwd[idx].real() : reservoirResponse<double, Boundary>(z, ctx, layout);
+            if (batch.pwd) batch.pwd[idx] = pwd;
+            batch.values[idx] = wellboreWrap<double, Storage>(z, pwd, ctx);
+        }
+    });
+}
+
+double ModelKernel::stehfestInvert(double t, int N, const std::function<double(double)>& laplaceFunc)
+{
+    double ln2 = std::log(2.0);
+    const double* V = stehfestTable(N);
+    double pd_val = 0.0;
+    for (int m = 1; m <= N; ++m) {
+        double z = m * ln2 / t;
+        double pf = laplaceFunc(z);
+        if (std::isnan(pf) || std::isinf(pf)) pf = 0.0;
+        pd_val += (V ? V[m - 1] : computeStehfestCoefficient(m, N)) * pf;
+    }
+    return pd_val * ln2 / t;
+}
+
+double ModelKernel::flaplace_composite(double z, const ModelContext& ctx)
+{
+    const FractureLayout layout(ctx);
+    return dispatchModel(ctx.type, [&](auto boundary, auto storage) {
+        return flaplaceImpl<double, decltype(boundary)::value, decltype(storage)::value>(z, ctx, layout);
+    });
+}
+
+std::complex<double> ModelKernel::flaplace_composite(std::complex<double> z, const ModelContext& ctx)
+{
+    const FractureLayout layout(ctx);
+    return dispatchModel(ctx.type, [&](auto boundary, auto storage) {
+        return flaplaceImpl<cplx, decltype(boundary)::value, decltype(storage)::value>(z, ctx, layout);
+    });
+}
+
+void ModelKernel::flaplace_composite(const double* z, int n, const ModelContext& ctx, double* out)
+{
+    if (n <= 0) return;
+    std::vector<cplx> s(z, z + n), values((size_t)n);
+    evaluateLaplace(s.data(), n, false, ctx, values.data());
+    for (int i = 0; i < n; ++i) out[i] = values[i].real();
+}
+
+void ModelKernel::flaplace_composite(const std::complex<double>* z, int n, const ModelContext& ctx,
+                                     std::complex<double>* out)
+{
+    evaluateLaplace(z, n, true, ctx, out);
+}
+
+double ModelKernel::PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD,
+                                  int nf, const std::vector<double>& xwD, ModelType type)
+{
+    return dispatchBoundary(type, [&](auto boundary) {
+        return pwdCompositeImpl<double, decltype(boundary)::value>(z, fs1, fs2, M12, LfD, rmD, reD, nf, xwD.data());
+    });
+}
+
+std::complex<double> ModelKernel::PWD_composite(std::complex<double> z, std::complex<double> fs1, double fs2, double M12,
+                                                double LfD, double rmD, double reD,
+                                                int nf, const std::vector<double>& xwD, ModelType type)
+{
+    return dispatchBoundary(type, [&](auto boundary) {
+        return pwdCompositeImpl<cplx, decltype(boundary)::value>(z, fs1, fs2, M12, LfD, rmD, reD, nf, xwD.data());
+    });
+}
+
+template<class T, int Boundary, bool Storage>
+T ModelKernel::flaplaceImpl(T z, const ModelContext& ctx, const FractureLayout& layout)
+{
+    return wellboreWrap<T, Storage>(z, reservoirResponse<T, Boundary>(z, ctx, layout), ctx);
+}
+
+template<class T, int Boundary>
+T ModelKernel::reservoirResponse(T z, const ModelContext& ctx, const FractureLayout& layout)
+{
+    double temp = ctx.omega2;
+    T fs1 = ctx.omega1 + ctx.lambda1 * temp / (ctx.lambda1 + z * temp);
+
+    return pwdCompositeImpl<T, Boundary>(z, fs1, layout.fs2, layout.M12, ctx.LfD, ctx.rmD, ctx.reD, layout.nf,
+                                         layout.xwD, ctx.fractureSolver, ctx.compressFarField);
+}
+
+template<class T, bool Storage>
+T ModelKernel::wellboreWrap(T z, T pf, const ModelContext& ctx)
+{
+    if (Storage) {
+        double CD = ctx.cD;
+        double S = ctx.S;
+        if (CD > 1e-12 || std::abs(S) > 1e-12) {
+            pf = (z * pf + S) / (z + CD * z * z * (z * pf + S));
+        }
+    }
+
+    return pf;
+}
+
+template<class T, int Boundary>
+T ModelKernel::pwdCompositeImpl(T z, T fs1, double fs2, double M12, double LfD, double rmD, double reD,
+                                int nf, const double* xwD, int solver, bool compressFarField)
+{
+    T gama1 = std::sqrt(z * fs1);
+    T gama2 = std::sqrt(z * fs2);
+    T arg_g2_rm = gama2 * rmD;
+    T arg_g1_rm = gama1 * rmD;
+    T arg_re = gama2 * reD;
+
+    // 边界项所需的贝塞尔函数一次批量计算: 宗量依次为 γ2·rmD, γ1·rmD, γ2·reD (无限大边界不需要第三项)
+    enum { G2_RM = 0, G1_RM, RE, MaxBoundaryArgs };
+    const int boundaryArgs = (Boundary == InfiniteBoundary) ? RE : MaxBoundaryArgs;
+    T args[MaxBoundaryArgs] = { arg_g2_rm, arg_g1_rm, arg_re };
+    T expNeg[MaxBoundaryArgs];
+    T k0s[MaxBoundaryArgs], k1s[MaxBoundaryArgs], i0s[MaxBoundaryArgs], i1s[MaxBoundaryArgs];
+    boundaryBessel(args, boundaryArgs, k0s, k1s, i0s, i1s, expNeg);
+
+    T k0_g2 = k0s[G2_RM] * expNeg[G2_RM];
+    T k1_g2 = k1s[G2_RM] * expNeg[G2_RM];
+    T k0_g1 = k0s[G1_RM] * expNeg[G1_RM];
+    T k1_g1 = k1s[G1_RM] * expNeg[G1_RM];
+
+    T term_mAB_i0 = 0.0;
+    T term_mAB_i1 = 0.0;
+
+    if (Boundary != InfiniteBoundary) {
+        T i1_re_s = i1s[RE];
+        T i0_re_s = i0s[RE];
+        T k1_re = k1s[RE] * expNeg[RE];
+        T k0_re = k0s[RE] * expNeg[RE];
+        T i0_g2_s = i0s[G2_RM];
+        T i1_g2_s = i1s[G2_RM];
+
+        if (Boundary == ClosedBoundary) {
+            if (std::abs(i1_re_s) > 1e-100) {
+                term_mAB_i0 = (k1_re / i1_re_s) * i0_g2_s * std::exp(arg_g2_rm - arg_re);
+                term_mAB_i1 = (k1_re / i1_re_s) * i1_g2_s * std::exp(arg_g2_rm - arg_re);
+            }
+        } else {
+            if (std::abs(i0_re_s) > 1e-100) {
+                term_mAB_i0 = -(k0_re / i0_re_s) * i0_g2_s * std::exp(arg_g2_rm - arg_re);
+                term_mAB_i1 = -(k0_re / i0_re_s) * i1_g2_s * std::exp(arg_g2_rm - arg_re);
+            }
+        }
+    }
+
+    T term1 = term_mAB_i0 + k0_g2;
+    T term2 = term_mAB_i1 - k1_g2;
+
+    T Acup = M12 * gama1 * k1_g1 * term1 + gama2 * k0_g1 * term2;
+
+    T i1_g1_s = i1s[G1_RM];
+    T i0_g1_s = i0s[G1_RM];
+
+    T Acdown_scaled = M12 * gama1 * i1_g1_s * term1 - gama2 * i0_g1_s * term2;
+
+    if (std::abs(Acdown_scaled) < 1e-100) Acdown_scaled = 1e-100;
+
+    T Ac_prefactor = Acup / Acdown_scaled;
+
+    // 影响系数矩阵 G (nf×nf) 与工作向量: nf <= MaxStackFractures 时在栈上，否则在堆上；
+    // 迭代求解时不装配 G
+    T gStack[MaxStackFractures * MaxStackFractures], yStack[MaxStackFractures], offsetStack[MaxStackFractures];
+    std::vector<T> heap, gHeap;
+    T* G = gStack;
+    T* y = yStack;
+    T* offsetValues = offsetStack;
+    if (nf > MaxStackFractures) {
+        heap.resize(2 * (size_t)nf);
+        y = heap.data(); offsetValues = y + nf;
+    }
+    auto denseMatrix = [&]() -> T* {
+        if (nf > MaxStackFractures) { gHeap.resize((size_t)nf * nf); G = gHeap.data(); }
+        return G;
+    };
+
+    // 裂缝 i 对裂缝 j 的影响积分只依赖于相对位置 (dx, dy)，且积分区间 [-LfD, LfD] 关于 0 对称，
+    // 因此 A(i,j) = A(j,i)。对均匀布缝 (Toeplitz 结构) 只有 nf 个不同的间距，每个间距只积分一次。
+    auto influence = [&](double dx, double dy, bool farField) -> T {
+        T val = 0.0;
+        if (dy == 0.0) {
+            // 同一直线上的线源: 令 u = |dx - a|，K0 的对数奇异性由 Ki(x) 解析扣除，其余部分定阶积分
+            double d = std::abs(dx);
+            if (farField && d >= FarFieldRatio * LfD) {
+                val = lineSourceSegment<FarFieldOrder>(d - LfD, d + LfD, gama1, Ac_prefactor, arg_g1_rm);
+            } else if (d >= LfD) {
+                val = lineSourceSegment<16>(d - LfD, d + LfD, gama1, Ac_prefactor, arg_g1_rm);
+            } else {
+                val = lineSourceSegment<16>(0.0, LfD - d, gama1, Ac_prefactor, arg_g1_rm)
+                    + lineSourceSegment<16>(0.0, LfD + d, gama1, Ac_prefactor, arg_g1_rm);
+            }
+        } else {
+            // 不在同一直线上的线源 (当前布缝方式不会出现): 被积函数光滑，子区间宽度取 min(8/|γ|, |dy|)，最多 64 段
+            auto integrand = [&](double a) -> T {
+                double dist = std::sqrt(std::pow(dx - a, 2) + std::pow(dy, 2));
+                T arg_dist = gama1 * dist;
+
+                T term2 = 0.0;
+                T exponent = arg_dist - arg_g1_rm;
+                if (realPart(exponent) > -700.0) {
+                    term2 = Ac_prefactor * ModelBessel::i0e(arg_dist) * std::exp(exponent);
+                }
+                return ModelBessel::k0e(arg_dist) * std::exp(-arg_dist) + term2;
+            };
+            double width = std::max(std::min(8.0 / std::abs(gama1), std::abs(dy)), 2.0 * LfD / 64.0);
+            val = ModelQuadrature::compositeGaussLegendre<16>(integrand, -LfD, LfD, width);
+        }
+        return z * val / (M12 * z * 2.0 * LfD);
+    };
+
+    // 当前布缝方式下所有裂缝位于 yD = 0
+    if (isUniformSpacing(xwD, nf)) {
+        double dx = (nf > 1) ? (xwD[nf - 1] - xwD[0]) / (nf - 1) : 0.0;
+        bool iterative = useIterativeSolver(solver, nf);
+        for (int k = 0; k < nf; ++k) offsetValues[k] = influence(k * dx, 0.0, iterative && compressFarField);
+        if (iterative && ModelToeplitz::solveUnitRhs(offsetValues, nf, y, IterativeTolerance)) {
+            T sum = 0.0;
+            for (int i = 0; i < nf; ++i) sum += y[i];
+            return T(1.0) / (z * sum);
+        }
+        denseMatrix();
+        for (int i = 0; i < nf; ++i) {
+            for (int j = 0; j < nf; ++j) G[i * nf + j] = offsetValues[std::abs(i - j)];
+        }
+    } else {
+        denseMatrix();
+        for (int i = 0; i < nf; ++i) {
+            for (int j = i; j < nf; ++j) {
+                G[i * nf + j] = influence(xwD[i] - xwD[j], 0.0, false);
+                G[j * nf + i] = G[i * nf + j];
+            }
+        }
+    }
+
+    return T(1.0) / (z * solveUnitSum(G, y, nf));
+}
+
+template<int Order, class T>
+T ModelKernel::lineSourceSegment(double a, double b, T gama1, T Ac_prefactor, T arg_g1_rm)
+{
+    using namespace ModelQuadrature;
+
+    // 被积函数的光滑部分: Ac * I0(γu) * exp(-γ rmD)，整批节点一次计算
+    // fullIntegrand 再加上 K0(γu)
+    auto smoothPart = [&](const double* u, T* out, int n) { lineSourceBatch(u, out, n, gama1, Ac_prefactor, arg_g1_rm, false); };
+    auto fullIntegrand = [&](const double* u, T* out, int n) { lineSourceBatch(u, out, n, gama1, Ac_prefactor, arg_g1_rm, true); };
+
+    // 复数 γ 时振荡由 |γ| 决定，衰减/增长由 Re γ 决定 (实数时两者相同)
+    double gAbs = std::abs(gama1);
+    double gRe = std::max(realPart(gama1), 1e-300);
+    T total = 0.0;
+
+    // 1. 近场 |γ|u <= K0SeriesLimit: K0 部分解析积分，I0 部分为整函数，单段 Order 点 Gauss 积分
+    double c = std::min(b, K0SeriesLimit / gAbs);
+    if (a < c) {
+        total += (integralK0(gama1 * c) - integralK0(gama1 * a)) / gama1;
+        total += gaussLegendreBatch<Order, T>(smoothPart, a, c);
+        a = c;
+    }
+    if (!(a < b)) return total;
+
+    // 2. 远场被积函数光滑，按 |γ| 宽度不超过 8 分段积分。
+    //    K0 在 Re(γ)u > 50 后可忽略，I0 部分单调递增，只有距上限 40/Re(γ) 以内的部分有贡献，
+    //    因此实数 γ 时分段数不超过 6 + 5 段，积分点总数有确定上界。
+    const double panelWidth = 8.0 / gAbs;
+    double kEnd = std::min(b, 50.0 / gRe);
+    double iStart = std::max(a, b - 40.0 / gRe);
+    if (kEnd >= iStart) {
+        total += compositeGaussLegendreBatch<Order, T>(fullIntegrand, a, b, panelWidth);
+    } else {
+        total += compositeGaussLegendreBatch<Order, T>(fullIntegrand, a, kEnd, panelWidth);
+        total += compositeGaussLegendreBatch<Order, T>(fullIntegrand, iStart, b, panelWidth);
+    }
+    return total;
+}
+
+bool ModelKernel::useIterativeSolver(int solver, int nf)
+{
+    if (solver == IterativeFractureSolver) return nf > 1;
+    return solver == AutoFractureSolver && nf >= IterativeMinFractures;
+}
+
+bool ModelKernel::isUniformSpacing(const double* xwD, int nf)
+{
+    if (nf <= 1) return true;
+    double dx = (xwD[nf - 1] - xwD[0]) / (nf - 1);
+    double tol = 1e-9 * (std::abs(xwD[nf - 1] - xwD[0]) + 1.0);
+    for (int i = 0; i < nf; ++i) {
+        if (std::abs(xwD[i] - (xwD[0] + i * dx)) > tol) return false;
+    }
+    return true;
+}
+
+double ModelKernel::stefestCoefficient(int i, int N)
+{
+    const double* V = stehfestTable(N);
+    if (V && i >= 1 && i <= N) return V[i - 1];
+    return computeStehfestCoefficient(i, N);
+}
+
+const double* ModelKernel::stehfestTable(int N)
+{
+    if (N < StehfestMinN || N > StehfestMaxN || N % 2 != 0) return nullptr;
+
+    // 所有支持的 N 的系数在首次调用时一次性生成 (C++11 保证局部静态变量初始化线程安全)
+    struct Table {
+        double V[(StehfestMaxN - StehfestMinN) / 2 + 1][StehfestMaxN];
+        Table() {
+            for (int n = StehfestMinN; n <= StehfestMaxN; n += 2) {
+                for (int i = 1; i <= n; ++i) V[(n - StehfestMinN) / 2][i - 1] = computeStehfestCoefficient(i, n);
+            }
+        }
+    };
+    static const Table table;
+    return table.V[(N - StehfestMinN) / 2];
+}
+
+double ModelKernel::computeStehfestCoefficient(int i, int N)
+{
+    // 使用 long double 累加，减小 N 较大时阶乘比值的舍入误差
+    long double s = 0.0L; int k1 = (i + 1) / 2; int k2 = std::min(i, N / 2);
+    for (int k = k1; k <= k2; ++k) {
+        long double num = std::pow((long double)k, N / 2.0L) * factorial(2 * k);
+        long double den = (long double)factorial(N / 2 - k) * factorial(k) * factorial(k - 1) * factorial(i - k) * factorial(2 * k - i);
+        if(den!=0) s += num/den;
+    }
+    return ((i + N / 2) % 2 == 0 ? 1.0 : -1.0) * (double)s;
+}
+
+double ModelKernel::factorial(int n) { if(n<=1)return 1; double r=1; for(int i=2;i<=n;++i)r*=i; return r; }
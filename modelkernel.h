@@ -0,0 +1,189 @@
+/*
+ * 文件名: modelkernel.h
+ * 文件作用: 压裂水平井复合页岩油模型计算内核头文件 (无界面依赖)
+ * 功能描述:
+ * 1. 定义6种边界/井储组合的模型类型枚举。
+ * 2. 定义单次曲线计算使用的不可变上下文 ModelContext，所有计算状态均由调用方传入。
+ * 3. 声明拉普拉斯空间解 flaplace_composite / PWD_composite 及 Stehfest 数值反演接口。
+ * 4. 仅依赖标准库，不持有任何可变成员 (可选的进程级缓存自带锁)，可在多个线程中同时调用。
+ * 5. 拉普拉斯空间解同时提供实数与复数 z 两个版本，反演算法 (Stehfest/Talbot/de Hoog/Euler) 由 ModelContext 选择。
+ * 6. 压力导数 tD·dpD/dtD 由 s·p̄(s) 直接反演，与 pD 共用拉普拉斯计算。
+ * 7. 拉普拉斯空间解按外边界类型与井储类型编译期特化，每条曲线 (或每次公开接口调用) 只按 ModelType 分派一次。
+ * 8. ctx.cacheResponse 为真时储层响应 PWD(z) 经进程级缓存复用 (线程安全)，计算结果与不使用缓存逐位一致。
+ * 9. 裂缝系统默认对 nf×nf 影响矩阵直接消元；nf 较大时 (均匀布缝) 改用 FFT Toeplitz 乘积 + 预条件 GMRES，
+ *    计算量由 O(nf³) 降为 O(nf log nf) 每次迭代 (见 modeltoeplitz.h)，由 ctx.fractureSolver 选择。
+ * 10. 提供批量拉普拉斯接口 (一组 z 一次调用)，反演内部即使用该路径。
+ */
+
+#ifndef MODELKERNEL_H
+#define MODELKERNEL_H
+
+#include <vector>
+#include <complex>
+#include <functional>
+
+#include "modelinversion.h"
+
+struct ModelContext;
+
+// 反演诊断信息 (calculatePD 的可选输出)
+struct InversionReport
+{
+    std::vector<double> errorEstimate;  // 各时间点 pD 的绝对误差估计 (已计入 gamaD 修正)
+    std::vector<double> derivativeErrorEstimate; // 各时间点 tD·dpD/dtD 的绝对误差估计 (仅计算导数时输出)
+    long long evaluations = 0;          // 反演公式使用的拉普拉斯值个数 (各时间点节点数之和)
+    long long laplaceEvaluations = 0;   // 实际计算的拉普拉斯值个数 (重合节点只计一次，不含缓存命中)
+    double maxErrorEstimate = 0.0;      // 误差估计的最大值
+};
+
+class ModelKernel
+{
+public:
+    enum ModelType {
+        Model_1 = 0, // 无限大 + 变井储
+        Model_2,     // 无限大 + 恒定井储
+        Model_3,     // 封闭边界 + 变井储
+        Model_4,     // 封闭边界 + 恒定井储
+        Model_5,     // 定压边界 + 变井储
+        Model_6      // 定压边界 + 恒定井储
+    };
+
+    // 外边界类型: 拉普拉斯空间解按 (外边界, 是否变井储) 编译期特化
+    enum BoundaryKind {
+        InfiniteBoundary = 0,
+        ClosedBoundary,
+        ConstPressureBoundary
+    };
+
+    // 模型类型判断
+    static bool hasStorage(ModelType type);
+    static bool isInfinite(ModelType type);
+    static bool isClosed(ModelType type);
+    static bool isConstPressure(ModelType type);
+    static BoundaryKind boundaryKind(ModelType type);
+
+    // 计算无因次压力 pD(tD)，包含数值反演 (ctx.inversionMethod) 和应力敏感 (gamaD) 修正
+    // 按 ctx.threadCount 将各时间点的反演项分配到线程池，结果与线程数无关
+    // report 非空时输出各时间点的误差估计与拉普拉斯函数计算次数
+    static void calculatePD(const std::vector<double>& tD, const ModelContext& ctx, std::vector<double>& outPD,
+                            InversionReport* report = nullptr);
+
+    // 同时计算 pD 及其对数导数 tD·dpD/dtD。L{dp/dt} = s·p̄(s) (p(0) = 0)，
+    // 导数由同一组拉普拉斯值乘以 s 后反演得到，不增加拉普拉斯计算次数，也没有数值微分的平滑偏差
+    static void calculatePDAndDerivative(const std::vector<double>& tD, const ModelContext& ctx,
+                                         std::vector<double>& outPD, std::vector<double>& outDeriv,
+                                         InversionReport* report = nullptr);
+
+    // Stehfest 反演单个时间点: f(t) = ln2/t * sum(Vi * F(i*ln2/t))
+    static double stehfestInvert(double t, int N, const std::function<double(double)>& laplaceFunc);
+
+    // 拉普拉斯空间解 (复合模型通用入口)，复数版本要求 Re(sqrt(z)) > 0
+    static double flaplace_composite(double z, const ModelContext& ctx);
+    static std::complex<double> flaplace_composite(std::complex<double> z, const ModelContext& ctx);
+    // 批量拉普拉斯空间解: out[i] = p̄(z[i])，i < n。模型分派与裂缝布置等准备只做一次，
+    // 各 z 按 ctx.threadCount 并行 (结果与线程数无关)；ctx.cacheResponse 时经储层响应缓存
+    static void flaplace_composite(const double* z, int n, const ModelContext& ctx, double* out);
+    static void flaplace_composite(const std::complex<double>* z, int n, const ModelContext& ctx,
+                                   std::complex<double>* out);
+
+    // PWD 核心计算 (包含边界条件处理)
+    static double PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD,
+                                int nf, const std::vector<double>& xwD, ModelType type);
+    static std::complex<double> PWD_composite(std::complex<double> z, std::complex<double> fs1, double fs2, double M12,
+                                              double LfD, double rmD, double reD,
+                                              int nf, const std::vector<double>& xwD, ModelType type);
+
+    // Stehfest 系数 Vi (i = 1..N)
+    static double stefestCoefficient(int i, int N);
+
+    // 预计算的 Stehfest 系数表 (支持 N = 4, 6, ..., 20)，返回 V1..VN，不支持的 N 返回 nullptr
+    // 系数表在首次使用时生成一次，之后各线程只读共享
+    static const double* stehfestTable(int N);
+    static const int StehfestMinN = 4;
+    static const int StehfestMaxN = 20;
+
+    // 裂缝条数不超过该值时，单次拉普拉斯计算的全部工作数组 (裂缝位置、影响系数矩阵) 都在栈上，不分配堆内存
+    static const int MaxStackFractures = 16;
+
+    // 裂缝系统的求解方式: Auto 在均匀布缝且 nf >= IterativeMinFractures 时使用迭代求解，否则直接消元
+    enum FractureSolver {
+        AutoFractureSolver = 0,
+        DirectFractureSolver,
+        IterativeFractureSolver
+    };
+    static const int IterativeMinFractures = 64;
+    // 迭代求解的相对残差，未收敛时改用直接消元
+    static constexpr double IterativeTolerance = 1e-13;
+    // 远场压缩: 间距 d >= FarFieldRatio·LfD 的影响积分改用 FarFieldOrder 点 Gauss 公式
+    // (被积函数在积分区间外 (FarFieldRatio - 1)·LfD 处才有奇点，8 点公式的相对误差约 1e-14)
+    static constexpr double FarFieldRatio = 4.0;
+    static const int FarFieldOrder = 8;
+
+private:
+    // 一条曲线全部 (t, 节点) 组合的输入输出 (定义见 modelkernel.cpp)
+    struct NodeBatch;
+    // 裂缝位置与只依赖参数的储层常数，每批计算准备一次 (定义见 modelkernel.cpp)
+    struct FractureLayout;
+
+    // 实数/复数 z 共用的实现 (T 为 double 或 std::complex<double>)，
+    // Boundary 为 BoundaryKind，Storage 表示是否带变井储/表皮修正；六种模型各对应一组特化
+    template<class T, int Boundary, bool Storage>
+    static T flaplaceImpl(T z, const ModelContext& ctx, const FractureLayout& layout);
+    // 储层响应 PWD(z): 只依赖储层参数，不含井储/表皮
+    template<class T, int Boundary>
+    static T reservoirResponse(T z, const ModelContext& ctx, const FractureLayout& layout);
+    // 井储/表皮外层修正 (z·pf + S) / (z + CD·z²·(z·pf + S))
+    template<class T, bool Storage>
+    static T wellboreWrap(T z, T pf, const ModelContext& ctx);
+    template<class T, int Boundary>
+    static T pwdCompositeImpl(T z, T fs1, double fs2, double M12, double LfD, double rmD, double reD,
+                              int nf, const double* xwD, int solver = AutoFractureSolver, bool compressFarField = false);
+    // 批量计算 s[0..count) 的拉普拉斯值 (经储层响应缓存)，返回实际计算 (未命中缓存) 的个数
+    static int evaluateLaplace(const std::complex<double>* s, int count, bool complexNodes, const ModelContext& ctx,
+                               std::complex<double>* values);
+    // 并行计算一批节点的拉普拉斯值 (每批按模型类型分派一次)
+    template<int Boundary, bool Storage>
+    static void evaluateNodes(const NodeBatch& batch, const ModelContext& ctx);
+    // 同一直线上线源影响积分的一段: ∫_a^b [K0(γu) + Ac·I0(γu)·e^(-γ rmD)] du, 0 <= a < b
+    // Order 为各子区间的 Gauss 点数 (近场 16，远场压缩时 FarFieldOrder)
+    template<int Order, class T>
+    static T lineSourceSegment(double a, double b, T gama1, T Ac_prefactor, T arg_g1_rm);
+    // 生成反演节点、计算拉普拉斯值并组合出 pD (outDeriv 非空时同时输出对数导数)
+    static void invertCurve(const std::vector<double>& tD, const ModelContext& ctx, std::vector<double>& outPD,
+                            std::vector<double>* outDeriv, InversionReport* report);
+    // 裂缝是否沿同一直线等间距分布 (可使用 Toeplitz 装配)
+    static bool isUniformSpacing(const double* xwD, int nf);
+    // 是否使用 Toeplitz 迭代求解 (solver 为 FractureSolver)
+    static bool useIterativeSolver(int solver, int nf);
+    static double factorial(int n);
+    static double computeStehfestCoefficient(int i, int N);
+};
+
+// 单次计算的不可变上下文 (由调用方一次性构造，计算过程中只读)
+struct ModelContext
+{
+    ModelKernel::ModelType type = ModelKernel::Model_1;
+
+    double kf = 1e-3;       // 内区渗透率
+    double km = 1e-4;       // 外区渗透率
+    double LfD = 0.1;       // 无因次裂缝半长
+    double rmD = 4.0;       // 无因次内区半径
+    double reD = 0.0;       // 无因次外边界半径 (无限大模型不使用)
+    double omega1 = 0.4;    // 储容比1
+    double omega2 = 0.08;   // 储容比2
+    double lambda1 = 1e-3;  // 窜流系数
+    double gamaD = 0.0;     // 无因次应力敏感系数
+    double cD = 0.0;        // 无因次井筒储集系数
+    double S = 0.0;         // 表皮系数
+    int nf = 4;             // 裂缝条数
+
+    ModelInversion::Method inversionMethod = ModelInversion::Stehfest; // 反演算法
+    int stehfestN = 4;      // Stehfest 反演项数 (偶数)
+    int inversionOrder = 0; // Talbot/de Hoog/Euler 的阶数，<=0 使用 ModelInversion::defaultOrder
+    int threadCount = 1;    // 反演线程数: 1 为串行，<=0 表示使用全部核心
+    bool cacheResponse = false; // 是否经 ModelResponseCache 复用储层响应 PWD(z) (不影响结果)
+    ModelKernel::FractureSolver fractureSolver = ModelKernel::AutoFractureSolver; // 裂缝系统求解方式
+    bool compressFarField = true; // 迭代求解时远场影响积分降阶 (仅迭代求解使用)
+};
+
+#endif // MODELKERNEL_H
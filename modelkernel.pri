@@ -0,0 +1,46 @@
+######################################################################
+# 试井模型计算内核 (ModelKernel)
+# 纯 C++17 实现，仅依赖 Eigen，不依赖 Qt 界面模块。
+# 由 WellTest.pro 直接包含，也可通过 modelkernel.pro 单独编译为静态库。
+######################################################################
+
+INCLUDEPATH += $$PWD
+
+HEADERS += $$PWD/modelkernel.h \
+           $$PWD/modelthreadpool.h \
+           $$PWD/modelquadrature.h \
+           $$PWD/modelbessel.h \
+           $$PWD/modelinversion.h \
+           $$PWD/modelcurvegrid.h \
+           $$PWD/modelresponsecache.h \
+           $$PWD/modelparams.h \
+           $$PWD/modeltoeplitz.h \
+           $$PWD/modelsweep.h \
+           $$PWD/modelfitter.h
+
+SOURCES += $$PWD/modelkernel.cpp \
+           $$PWD/modelthreadpool.cpp \
+           $$PWD/modelbessel.cpp \
+           $$PWD/modelinversion.cpp \
+           $$PWD/modelcurvegrid.cpp \
+           $$PWD/modelresponsecache.cpp \
+           $$PWD/modelparams.cpp \
+           $$PWD/modelsweep.cpp \
+           $$PWD/modelfitter.cpp
+
+# 内核线程池使用 std::thread
+unix: LIBS += -lpthread
+
+# 贝塞尔函数的 SIMD 指令集 (默认标量实现，目标机器支持时可在 qmake 参数中开启):
+#   qmake "CONFIG+=model_avx2"    -> AVX2 + FMA，每次计算 4 个宗量
+#   qmake "CONFIG+=model_avx512"  -> AVX-512F，每次计算 8 个宗量
+model_avx512 {
+    msvc: QMAKE_CXXFLAGS += /arch:AVX512
+    else: QMAKE_CXXFLAGS += -mavx512f -mavx2 -mfma
+} else: model_avx2 {
+    msvc: QMAKE_CXXFLAGS += /arch:AVX2
+    else: QMAKE_CXXFLAGS += -mavx2 -mfma
+}
+
+# 第三方数学库路径
+INCLUDEPATH += D:/08YYYXXX/eigen-3.3.8
@@ -0,0 +1,14 @@
+######################################################################
+# 试井模型计算内核静态库 (无界面，可用于批量计算/多线程任务)
+######################################################################
+TEMPLATE = lib
+TARGET = ModelKernel
+CONFIG += staticlib c++17
+CONFIG -= qt
+
+# 编译优化选项
+QMAKE_CXXFLAGS += -O3
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
+
+include(modelkernel.pri)
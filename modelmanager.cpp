@@ -11,6 +11,7 @@
 #include "modelselect.h"
 #include "modelparameter.h"
 #include "modelwidget01-06.h" // 包含合并后的类
+#include "modelsolver.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -221,23 +222,44 @@ QMap<QString, double> ModelManager::getDefaultParameters(ModelType type)
     return p;
 }
 
-ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime)
+ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime, bool highPrecision)
 {
     int index = (int)type;
-    if (index >= 0 && index < m_modelWidgets.size()) {
-        return m_modelWidgets[index]->calculateTheoreticalCurve(params, providedTime);
-    }
-    return ModelCurveData();
+    if (index < Model_1 || index > Model_6) return ModelCurveData();
+    return ModelSolver::calculateTheoreticalCurve(type, params, providedTime, highPrecision);
+}
+
+ModelCurveData ModelManager::calculateInterpolatedCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime, bool highPrecision)
+{
+    int index = (int)type;
+    if (index < Model_1 || index > Model_6) return ModelCurveData();
+    return ModelSolver::calculateInterpolatedCurve(type, params, providedTime, highPrecision);
+}
+
+ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type, const ModelParams& params, const QVector<double>& providedTime, bool highPrecision)
+{
+    int index = (int)type;
+    if (index < Model_1 || index > Model_6) return ModelCurveData();
+    return ModelSolver::calculateTheoreticalCurve(type, params, providedTime, highPrecision);
+}
+
+ModelCurveData ModelManager::calculateInterpolatedCurve(ModelType type, const ModelParams& params, const QVector<double>& providedTime, bool highPrecision, double relTol)
+{
+    int index = (int)type;
+    if (index < Model_1 || index > Model_6) return ModelCurveData();
+    return ModelSolver::calculateInterpolatedCurve(type, params, providedTime, highPrecision, relTol);
 }
 
 QVector<double> ModelManager::generateLogTimeSteps(int count, double startExp, double endExp) {
-    QVector<double> t;
-    t.reserve(count);
-    for (int i = 0; i < count; ++i) {
-        double exponent = startExp + (endExp - startExp) * i / (count - 1);
-        t.append(pow(10.0, exponent));
-    }
-    return t;
+    return ModelSolver::generateLogTimeSteps(count, startExp, endExp);
+}
+
+QVector<double> ModelManager::generateAlignedTimeSteps(int count, double startExp, double endExp) {
+    return ModelSolver::generateAlignedTimeSteps(count, startExp, endExp);
+}
+
+QVector<double> ModelManager::generateTimeSteps(int count, double startExp, double endExp) {
+    return ModelSolver::generateTimeSteps(count, startExp, endExp);
 }
 
 void ModelManager::setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d)
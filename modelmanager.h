@@ -37,12 +37,28 @@ public:
     static QString getModelTypeName(ModelType type);
 
     // 计算理论曲线接口 (供 FittingWidget 使用)
-    ModelCurveData calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
+    // 可重入: 直接调用无界面的 ModelSolver，不访问模型界面对象，可在拟合线程中调用
+    ModelCurveData calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params,
+                                             const QVector<double>& providedTime = QVector<double>(),
+                                             bool highPrecision = true);
+
+    // 插值模式的理论曲线: 自适应粗网格反演 + 对数-对数插值到 providedTime (拟合残差使用)
+    ModelCurveData calculateInterpolatedCurve(ModelType type, const QMap<QString, double>& params,
+                                              const QVector<double>& providedTime, bool highPrecision = false);
+
+    // 参数块版本 (拟合迭代使用，不做参数名查找)
+    ModelCurveData calculateTheoreticalCurve(ModelType type, const ModelParams& params,
+                                             const QVector<double>& providedTime = QVector<double>(),
+                                             bool highPrecision = true);
+    // relTol: 网格插值的相对误差上限 (全局搜索可放宽以减少反演点数)
+    ModelCurveData calculateInterpolatedCurve(ModelType type, const ModelParams& params,
+                                              const QVector<double>& providedTime, bool highPrecision = false,
+                                              double relTol = ModelSolver::DefaultGridTolerance);
 
     // 获取默认参数 (供 FittingWidget 使用)
     QMap<QString, double> getDefaultParameters(ModelType type);
 
-    // 设置所有模型的高精度模式
+    // 设置所有模型界面的高精度模式 (仅影响模型界面自身的计算)
     void setHighPrecision(bool high);
 
     // 刷新所有模型的基础参数
@@ -50,6 +66,10 @@ public:
 
     // 静态工具: 生成对数时间步长
     static QVector<double> generateLogTimeSteps(int count, double startExp, double endExp);
+    // 静态工具: 生成与 Stehfest 节点对齐的对数时间步长 (见 ModelSolver)
+    static QVector<double> generateAlignedTimeSteps(int count, double startExp, double endExp);
+    // 静态工具: 按系统设置生成默认时间步长 (对数均匀或与 Stehfest 节点对齐)
+    static QVector<double> generateTimeSteps(int count, double startExp, double endExp);
 
     // 数据缓存接口
     void setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
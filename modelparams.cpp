@@ -0,0 +1,34 @@
+/*
+ * 文件名: modelparams.cpp
+ * 文件作用: 模型参数块名称注册表实现
+ * 功能描述:
+ * 1. 枚举下标与参数名的对应表，只在界面/文件边界的转换中使用。
+ */
+
+#include "modelparams.h"
+
+#include <cstring>
+
+namespace {
+
+static_assert(ModelParams::Count <= 32, "assigned-parameter mask is a 32-bit word");
+
+const char* const s_names[ModelParams::Count] = {
+    "kf", "km", "L", "Lf", "LfD", "nf", "rmD", "reD", "omega1", "omega2", "lambda1",
+    "gamaD", "cD", "S", "phi", "mu", "B", "Ct", "q", "h", "N"
+};
+
+} // namespace
+
+const char* ModelParams::name(Id id)
+{
+    return (id >= 0 && id < Count) ? s_names[id] : "";
+}
+
+int ModelParams::indexOf(const char* name)
+{
+    for (int i = 0; i < Count; ++i) {
+        if (std::strcmp(s_names[i], name) == 0) return i;
+    }
+    return -1;
+}
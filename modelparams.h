@@ -0,0 +1,80 @@
+/*
+ * 文件名: modelparams.h
+ * 文件作用: 模型参数块头文件 (纯 C++ 实现，无 Qt 依赖)
+ * 功能描述:
+ * 1. ModelParams 以枚举下标存放全部模型参数 (固定布局的 double 数组 + 已赋值位掩码)，
+ *    复制、读取、修改都不做字符串比较，也不分配堆内存，供计算服务与拟合迭代使用。
+ * 2. 提供参数名 <-> 下标的注册表，界面、项目文件 (JSON) 等边界处由 ModelSolver 与 QMap 互相转换。
+ * 3. value(id, def) 与 QMap::value(key, def) 语义相同: 参数未赋值时返回调用方给出的默认值。
+ */
+
+#ifndef MODELPARAMS_H
+#define MODELPARAMS_H
+
+class ModelParams
+{
+public:
+    enum Id {
+        Kf = 0,     // 内区渗透率 kf
+        Km,         // 外区渗透率 km
+        L,          // 水平井长度 L
+        Lf,         // 裂缝半长 Lf
+        LfD,        // 无因次裂缝半长 (= Lf / L)
+        Nf,         // 裂缝条数 nf
+        RmD,        // 无因次内区半径 rmD
+        ReD,        // 无因次外边界半径 reD
+        Omega1,     // 储容比1 omega1
+        Omega2,     // 储容比2 omega2
+        Lambda1,    // 窜流系数 lambda1
+        GamaD,      // 无因次应力敏感系数 gamaD
+        CD,         // 无因次井筒储集系数 cD
+        S,          // 表皮系数 S
+        Phi,        // 孔隙度 phi
+        Mu,         // 粘度 mu
+        B,          // 体积系数 B
+        Ct,         // 综合压缩系数 Ct
+        Q,          // 产量 q
+        H,          // 有效厚度 h
+        N,          // Stehfest 项数 N
+        Count
+    };
+
+    ModelParams() : m_set(0)
+    {
+        for (int i = 0; i < Count; ++i) m_values[i] = 0.0;
+    }
+
+    bool has(Id id) const { return (m_set >> id) & 1u; }
+    double value(Id id, double defaultValue = 0.0) const { return has(id) ? m_values[id] : defaultValue; }
+    void set(Id id, double v) { m_values[id] = v; m_set |= 1u << id; }
+
+    // 参数联动: 同时给出 L 与 Lf 时更新 LfD = Lf / L
+    void updateDerived()
+    {
+        if (has(L) && has(Lf) && m_values[L] > 1e-9) set(LfD, m_values[Lf] / m_values[L]);
+    }
+
+    // 已赋值的参数集合与取值都相同 (用作缓存键，未赋值位置的残留值不参与比较)
+    bool operator==(const ModelParams& o) const
+    {
+        if (m_set != o.m_set) return false;
+        for (int i = 0; i < Count; ++i) {
+            if (((m_set >> i) & 1u) && m_values[i] != o.m_values[i]) return false;
+        }
+        return true;
+    }
+    bool operator!=(const ModelParams& o) const { return !(*this == o); }
+
+    // 名称注册表 (名称与界面、项目文件中使用的参数名一致)
+    static const char* name(Id id);
+    // 未注册的名称返回 -1
+    static int indexOf(const char* name);
+    // 只取整数值的参数 (计算时按整数使用，扫描等生成取值处需取整)
+    static bool isInteger(Id id) { return id == Nf || id == N; }
+
+private:
+    double m_values[Count];
+    unsigned m_set;
+};
+
+#endif // MODELPARAMS_H
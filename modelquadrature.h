@@ -0,0 +1,156 @@
+/*
+ * 文件名: modelquadrature.h
+ * 文件作用: 模型计算内核使用的定阶数值积分工具 (纯模板头文件，无 Qt 依赖)
+ * 功能描述:
+ * 1. 提供任意阶 Gauss-Legendre 求积公式，节点/权重在首次使用时由 Newton 迭代生成一次。
+ * 2. 被积函数作为模板参数传入，避免 std::function 的类型擦除开销，可被编译器内联。
+ * 3. 提供按最大子区间宽度等分的复合 Gauss-Legendre 积分，积分点数量有确定上界。
+ * 4. 提供批量版本: 被积函数一次接收一整批节点，便于调用向量化的特殊函数 (见 modelbessel.h)。
+ * 5. 提供 K0 积分函数 Ki(x) = ∫0^x K0(t) dt 的级数解析式，用于扣除 K0 在 t=0 处的对数奇异性。
+ * 6. 积分函数与 Ki(x) 同时支持实数与复数取值，供复拉普拉斯变量上的反演算法使用。
+ */
+
+#ifndef MODELQUADRATURE_H
+#define MODELQUADRATURE_H
+
+#include <cmath>
+#include <algorithm>
+
+namespace ModelQuadrature {
+
+// N 点 Gauss-Legendre 节点与权重 (区间 [-1, 1])
+template<int N>
+struct GaussLegendreRule
+{
+    double x[N];
+    double w[N];
+
+    GaussLegendreRule()
+    {
+        const double pi = 3.14159265358979323846;
+        for (int i = 0; i < (N + 1) / 2; ++i) {
+            double z = std::cos(pi * (i + 0.75) / (N + 0.5));
+            double dp = 1.0;
+            for (int iter = 0; iter < 100; ++iter) {
+                // 递推计算 P_N(z) 及其导数
+                double p0 = 1.0, p1 = z;
+                for (int k = 2; k <= N; ++k) {
+                    double p2 = ((2 * k - 1) * z * p1 - (k - 1) * p0) / k;
+                    p0 = p1; p1 = p2;
+                }
+                if (N == 1) p0 = 1.0;
+                dp = N * (z * p1 - p0) / (z * z - 1.0);
+                double dz = p1 / dp;
+                z -= dz;
+                if (std::abs(dz) < 1e-16) break;
+            }
+            x[i] = -z; x[N - 1 - i] = z;
+            w[i] = w[N - 1 - i] = 2.0 / ((1.0 - z * z) * dp * dp);
+        }
+    }
+
+    static const GaussLegendreRule& get()
+    {
+        static const GaussLegendreRule rule;
+        return rule;
+    }
+};
+
+// 单个区间 [a, b] 上的 N 点 Gauss-Legendre 积分
+// 被积函数可以返回 double 或 std::complex<double>
+template<int N, class F>
+inline auto gaussLegendre(const F& f, double a, double b) -> decltype(f(a))
+{
+    const GaussLegendreRule<N>& r = GaussLegendreRule<N>::get();
+    double h = 0.5 * (b - a), c = 0.5 * (a + b);
+    decltype(f(a)) s(0.0);
+    for (int i = 0; i < N; ++i) s += r.w[i] * f(c + h * r.x[i]);
+    return s * h;
+}
+
+// 复合 Gauss-Legendre 积分: 将 [a, b] 等分为宽度不超过 maxWidth 的子区间，每个子区间使用 N 点公式
+template<int N, class F>
+inline auto compositeGaussLegendre(const F& f, double a, double b, double maxWidth) -> decltype(f(a))
+{
+    decltype(f(a)) s(0.0);
+    if (!(b > a)) return s;
+    int panels = std::max(1, (int)std::ceil((b - a) / maxWidth));
+    double h = (b - a) / panels;
+    for (int p = 0; p < panels; ++p) s += gaussLegendre<N>(f, a + p * h, (p == panels - 1) ? b : a + (p + 1) * h);
+    return s;
+}
+
+// 批量被积函数单次调用的最大节点数
+const int MaxBatch = 128;
+
+// 批量版本的复合 Gauss-Legendre 积分
+// fb(const double* u, V* out, int n): 一次计算 n (<= MaxBatch) 个节点上的被积函数值，V 为 double 或复数
+template<int N, class V = double, class FB>
+inline V compositeGaussLegendreBatch(const FB& fb, double a, double b, double maxWidth)
+{
+    static_assert(N <= MaxBatch, "Gauss order exceeds batch size");
+    if (!(b > a)) return V(0.0);
+    const GaussLegendreRule<N>& r = GaussLegendreRule<N>::get();
+    const int panelsPerBatch = MaxBatch / N;
+    int panels = std::max(1, (int)std::ceil((b - a) / maxWidth));
+    double width = (b - a) / panels;
+
+    double u[MaxBatch];
+    V f[MaxBatch];
+    V s(0.0);
+    for (int p0 = 0; p0 < panels; p0 += panelsPerBatch) {
+        int count = std::min(panelsPerBatch, panels - p0);
+        for (int p = 0; p < count; ++p) {
+            double lo = a + (p0 + p) * width;
+            double hi = (p0 + p == panels - 1) ? b : lo + width;
+            double h = 0.5 * (hi - lo), c = 0.5 * (lo + hi);
+            for (int i = 0; i < N; ++i) u[p * N + i] = c + h * r.x[i];
+        }
+        fb(u, f, count * N);
+        for (int p = 0; p < count; ++p) {
+            double lo = a + (p0 + p) * width;
+            double hi = (p0 + p == panels - 1) ? b : lo + width;
+            V ps(0.0);
+            for (int i = 0; i < N; ++i) ps += r.w[i] * f[p * N + i];
+            s += ps * 0.5 * (hi - lo);
+        }
+    }
+    return s;
+}
+
+// 单个区间的批量 Gauss-Legendre 积分
+template<int N, class V = double, class FB>
+inline V gaussLegendreBatch(const FB& fb, double a, double b)
+{
+    return compositeGaussLegendreBatch<N, V>(fb, a, b, b - a);
+}
+
+// 级数解析式的适用上限: x <= 4 时各项最大约为 10，累加的舍入误差可忽略
+const double K0SeriesLimit = 4.0;
+
+// Ki(x) = ∫0^x K0(t) dt，由 K0 的级数展开逐项积分得到:
+// Ki(x) = Σ x^(2k+1) / (4^k (k!)^2 (2k+1)) * [-(ln(x/2) + γE) + 1/(2k+1) + H_k]
+// T 为 double (x >= 0) 或复数 (Re x >= 0，沿射线积分)
+template<class T>
+inline T integralK0(T x)
+{
+    if (x == T(0.0)) return T(0.0);
+    const double eulerGamma = 0.57721566490153286061;
+    T lnTerm = -(std::log(0.5 * x) + eulerGamma);
+    T q = 0.25 * x * x;
+    T c = x;            // x^(2k+1) / (4^k (k!)^2)
+    double H = 0.0;     // 调和数 H_k
+    T s(0.0);
+    for (int k = 0; k < 60; ++k) {
+        if (k > 0) { c *= q / ((double)k * k); H += 1.0 / k; }
+        double inv = 1.0 / (2 * k + 1);
+        T term = c * inv * (lnTerm + inv + H);
+        s += term;
+        if (std::abs(term) < 1e-17 * std::abs(s)) break;
+    }
+    return s;
+}
+
+} // namespace ModelQuadrature
+
+#endif // MODELQUADRATURE_H
@@ -0,0 +1,212 @@
+/*
+ * 文件名: modelresponsecache.cpp
+ * 文件作用: 储层响应 PWD(z) 缓存实现
+ * 功能描述:
+ * 1. 储层参数组按字段逐一比较 (不使用散列值作为唯一标识，避免碰撞)，最近使用的组在前。
+ * 2. z 以实部、虚部的位模式散列，只有完全相同的节点才命中，命中值与重新计算的结果逐位一致。
+ * 3. 全局节点计数按 EntryBytes 折算内存；插入前先预留名额，不足时淘汰最久未用的其他参数组。
+ *    锁顺序固定为 全局锁 -> 表锁，持有表锁时不再获取全局锁。
+ */
+
+#include "modelresponsecache.h"
+#include "modelkernel.h"
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+// 决定 PWD(z) 的参数: 外边界类型只区分无限大/封闭/定压，井储与表皮不计入；
+// 裂缝系统求解方式影响末位数字，也计入，保证命中值与重新计算逐位一致
+struct ReservoirKey
+{
+    int boundary = 0;
+    double kf = 0.0, km = 0.0, LfD = 0.0, rmD = 0.0, reD = 0.0;
+    double omega1 = 0.0, omega2 = 0.0, lambda1 = 0.0;
+    int nf = 0;
+    int solver = 0;
+    bool compressFarField = false;
+
+    explicit ReservoirKey(const ModelContext& ctx)
+        : boundary(ModelKernel::isInfinite(ctx.type) ? 0 : (ModelKernel::isClosed(ctx.type) ? 1 : 2))
+        , kf(ctx.kf), km(ctx.km), LfD(ctx.LfD), rmD(ctx.rmD)
+        , reD(ModelKernel::isInfinite(ctx.type) ? 0.0 : ctx.reD)
+        , omega1(ctx.omega1), omega2(ctx.omega2), lambda1(ctx.lambda1), nf(std::max(ctx.nf, 1))
+        , solver(ctx.fractureSolver), compressFarField(ctx.compressFarField)
+    {
+    }
+
+    bool operator==(const ReservoirKey& o) const
+    {
+        return boundary == o.boundary && kf == o.kf && km == o.km && LfD == o.LfD && rmD == o.rmD
+            && reD == o.reD && omega1 == o.omega1 && omega2 == o.omega2 && lambda1 == o.lambda1 && nf == o.nf
+            && solver == o.solver && compressFarField == o.compressFarField;
+    }
+};
+
+struct CacheEntry
+{
+    ReservoirKey key;
+    std::shared_ptr<ModelResponseCache::Table> table;
+};
+
+std::mutex s_mutex;
+std::vector<CacheEntry> s_entries;   // 按最近使用排序，最新的在前
+std::atomic<long long> s_hits(0);
+std::atomic<long long> s_misses(0);
+std::atomic<long long> s_evictions(0);
+std::atomic<long long> s_entryCount(0);
+std::atomic<size_t> s_memoryLimit(ModelResponseCache::DefaultMemoryLimit);
+
+long long entryBudget()
+{
+    return (long long)(s_memoryLimit.load() / ModelResponseCache::EntryBytes);
+}
+
+} // namespace
+
+size_t ModelResponseCache::Table::NodeHash::operator()(const std::complex<double>& z) const
+{
+    double parts[2] = { z.real(), z.imag() };
+    unsigned long long bits[2];
+    std::memcpy(bits, parts, sizeof(bits));
+    unsigned long long h = bits[0] * 0x9E3779B97F4A7C15ULL;
+    h ^= bits[1] + 0x7F4A7C159E3779B9ULL + (h << 6) + (h >> 2);
+    return (size_t)(h ^ (h >> 29));
+}
+
+void ModelResponseCache::Table::lookup(const std::complex<double>* z, int n, const char* active,
+                                       std::complex<double>* values, char* found)
+{
+    long long hits = 0, misses = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int i = 0; i < n; ++i) {
+            found[i] = 0;
+            if (!active[i]) continue;
+            auto it = m_values.find(z[i]);
+            if (it != m_values.end()) { values[i] = it->second; found[i] = 1; ++hits; }
+            else ++misses;
+        }
+    }
+    s_hits += hits;
+    s_misses += misses;
+}
+
+void ModelResponseCache::Table::insert(const std::complex<double>* z, int n, const char* fresh,
+                                       const std::complex<double>* values)
+{
+    int wanted = 0;
+    for (int i = 0; i < n; ++i) wanted += fresh[i] ? 1 : 0;
+    int allowed = wanted ? reserve(this, wanted) : 0;
+    if (allowed == 0) return;
+
+    int inserted = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_evicted) {
+            for (int i = 0; i < n && inserted < allowed; ++i) {
+                if (fresh[i] && m_values.emplace(z[i], values[i]).second) ++inserted;
+            }
+        }
+    }
+    // 其他线程已插入的相同节点、或表已被淘汰时，归还未使用的名额
+    if (inserted < allowed) release(allowed - inserted);
+}
+
+void ModelResponseCache::Table::evict()
+{
+    size_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_evicted) return;
+        m_evicted = true;
+        count = m_values.size();
+        std::unordered_map<std::complex<double>, std::complex<double>, NodeHash>().swap(m_values);
+    }
+    release((int)count);
+}
+
+std::shared_ptr<ModelResponseCache::Table> ModelResponseCache::table(const ModelContext& ctx)
+{
+    ReservoirKey key(ctx);
+    std::lock_guard<std::mutex> lock(s_mutex);
+    for (size_t i = 0; i < s_entries.size(); ++i) {
+        if (s_entries[i].key == key) {
+            std::rotate(s_entries.begin(), s_entries.begin() + i, s_entries.begin() + i + 1);
+            return s_entries.front().table;
+        }
+    }
+    s_entries.insert(s_entries.begin(), CacheEntry{ key, std::make_shared<Table>() });
+    while ((int)s_entries.size() > MaxParameterSets && evictOldest(s_entries.front().table.get())) {}
+    return s_entries.front().table;
+}
+
+// 淘汰最久未用的参数组 (跳过 keep)，调用方持有 s_mutex；没有可淘汰的组时返回 false
+bool ModelResponseCache::evictOldest(const Table* keep)
+{
+    for (size_t i = s_entries.size(); i-- > 0;) {
+        if (s_entries[i].table.get() == keep) continue;
+        std::shared_ptr<Table> victim = s_entries[i].table;
+        s_entries.erase(s_entries.begin() + i);
+        victim->evict();
+        ++s_evictions;
+        return true;
+    }
+    return false;
+}
+
+int ModelResponseCache::reserve(const Table* owner, int n)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    long long budget = entryBudget();
+    while (s_entryCount.load() + n > budget && evictOldest(owner)) {}
+    long long allowed = std::max(0LL, std::min((long long)n, budget - s_entryCount.load()));
+    s_entryCount += allowed;
+    return (int)allowed;
+}
+
+void ModelResponseCache::release(int n)
+{
+    s_entryCount -= n;
+}
+
+void ModelResponseCache::setMemoryLimit(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_memoryLimit = bytes;
+    long long budget = entryBudget();
+    while (s_entryCount.load() > budget && evictOldest(nullptr)) {}
+}
+
+size_t ModelResponseCache::memoryLimit()
+{
+    return s_memoryLimit.load();
+}
+
+void ModelResponseCache::clear()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    while (evictOldest(nullptr)) {}
+}
+
+ModelResponseCache::Stats ModelResponseCache::stats()
+{
+    Stats s;
+    s.hits = s_hits.load();
+    s.misses = s_misses.load();
+    s.evictions = s_evictions.load();
+    s.entries = (size_t)std::max(0LL, s_entryCount.load());
+    s.memoryBytes = s.entries * EntryBytes;
+    s.memoryLimit = s_memoryLimit.load();
+    return s;
+}
+
+void ModelResponseCache::resetStats()
+{
+    s_hits = 0;
+    s_misses = 0;
+    s_evictions = 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * 文件名: modelresponsecache.h
+ * 文件作用: 储层响应 PWD(z) 缓存头文件 (纯 C++ 实现，无 Qt 依赖)
+ * 功能描述:
+ * 1. 拉普拉斯空间解分两层: 代价高的裂缝系统求解 PWD(z) 只依赖储层参数 (外边界类型、kf、km、LfD、rmD、
+ *    reD、omega1、omega2、lambda1、nf)；井储/表皮 (cD、S) 只进入闭式外层修正，gamaD 在反演后才使用。
+ * 2. 按储层参数组缓存各拉普拉斯变量 z 上的 PWD 值。只调整 cD、S、gamaD (或在变井储与恒定井储模型之间切换)
+ *    时，反演只重算外层修正，不再求解裂缝系统；参数完全不变时 (重复刷新、被拒绝的拟合试探步) 全部命中。
+ * 3. 总内存由 setMemoryLimit 限定 (系统设置页配置)，超出时按参数组淘汰最久未用的组；
+ *    各组有独立互斥锁，反演时整批查找、整批插入，并行计算阶段不访问缓存。
+ */
+
+#ifndef MODELRESPONSECACHE_H
+#define MODELRESPONSECACHE_H
+
+#include <complex>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <cstddef>
+
+struct ModelContext;
+
+class ModelResponseCache
+{
+public:
+    // 参数组数量上限 (查找参数组为线性比较)
+    static const int MaxParameterSets = 64;
+    // 每个缓存值的内存估算 (键、值与散列表节点开销)
+    static const size_t EntryBytes = 64;
+    static const size_t DefaultMemoryLimit = size_t(64) << 20;
+
+    // 命中统计 (进程累计) 与当前占用
+    struct Stats
+    {
+        long long hits = 0;
+        long long misses = 0;
+        long long evictions = 0;   // 被淘汰的参数组数
+        size_t entries = 0;        // 当前缓存的 z 节点数
+        size_t memoryBytes = 0;    // entries * EntryBytes
+        size_t memoryLimit = 0;
+    };
+
+    // 一组储层参数下的 z -> PWD(z) 表
+    class Table
+    {
+    public:
+        // 对 active[i] 非 0 的 z[i] 查表，命中时写入 values[i] 并置 found[i] = 1
+        void lookup(const std::complex<double>* z, int n, const char* active,
+                    std::complex<double>* values, char* found);
+        // 插入 fresh[i] 非 0 的 (z[i], values[i])，超出内存上限的部分不插入
+        void insert(const std::complex<double>* z, int n, const char* fresh, const std::complex<double>* values);
+
+    private:
+        friend class ModelResponseCache;
+        // 由缓存淘汰: 释放全部值，之后的插入被忽略 (计算中的调用方可能仍持有该表)
+        void evict();
+
+        struct NodeHash
+        {
+            size_t operator()(const std::complex<double>& z) const;
+        };
+        std::mutex m_mutex;
+        bool m_evicted = false;
+        std::unordered_map<std::complex<double>, std::complex<double>, NodeHash> m_values;
+    };
+
+    // 取 ctx 的储层参数组对应的表 (不存在时创建)
+    static std::shared_ptr<Table> table(const ModelContext& ctx);
+
+    // 内存上限 (字节)，0 表示不缓存；降低上限时立即淘汰最久未用的参数组
+    static void setMemoryLimit(size_t bytes);
+    static size_t memoryLimit();
+
+    static void clear();
+    static Stats stats();
+    static void resetStats();
+
+private:
+    // 为 owner 预留 n 个节点 (必要时淘汰其他参数组)，返回实际可插入的数量
+    static int reserve(const Table* owner, int n);
+    static void release(int n);
+    // 淘汰最久未用的参数组 (跳过 keep)，调用方持有全局锁；没有可淘汰的组时返回 false
+    static bool evictOldest(const Table* keep);
+};
+
+#endif // MODELRESPONSECACHE_H
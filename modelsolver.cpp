@@ -0,0 +1,323 @@
+/*
+ * 文件名: modelsolver.cpp
+ * 文件作用: 理论曲线计算服务实现
+ * 功能描述:
+ * 1. 参数表 -> ModelContext 的转换。
+ * 2. 有因次时间/压力与无因次量之间的换算。
+ * 3. 调用 ModelKernel 完成反演，压力导数由拉普拉斯空间的 s·p̄(s) 直接反演 (不做数值微分)。
+ * 4. QMap 参数表只在接口处转换为 ModelParams，计算过程中不做字符串查找。
+ * 5. 插值模式下由 ModelCurveGrid 在自适应粗网格上反演后插值到请求时间点，
+ *    同一组无因次参数的主曲线被缓存，纯比例参数变化时直接平移插值。
+ * 6. 曲线结果缓存按最近使用排序，键中的参数块、时间点逐位比较；按条数与内存两项上限淘汰。
+ * 7. 默认时间网格为 2^(k/q) 格点，Stehfest 节点在相邻倍程间重合，配合内核的节点去重减少拉普拉斯计算。
+ */
+
+#include "modelsolver.h"
+#include "modelcurvegrid.h"
+
+#include <cmath>
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+namespace {
+// 反演并行线程数 (0 = 自动使用全部核心)
+std::atomic<int> s_inversionThreadCount(0);
+// 反演算法 (ModelInversion::Method)
+std::atomic<int> s_inversionMethod(ModelInversion::Stehfest);
+// 计算缓存内存上限 (MB)
+std::atomic<int> s_cacheLimitMB((int)(ModelResponseCache::DefaultMemoryLimit >> 20));
+// 默认时间网格是否与 Stehfest 节点对齐
+std::atomic<bool> s_alignedTimeSteps(false);
+
+// 曲线结果缓存: 结果只与下列字段有关 (线程数不影响结果)
+struct CurveMemoEntry
+{
+    ModelKernel::ModelType type;
+    ModelParams params;
+    QVector<double> time;
+    bool highPrecision;
+    double relTol;
+    int method;
+    ModelCurveData result;
+
+    bool matches(ModelKernel::ModelType t, const ModelParams& p, const QVector<double>& tm, bool hp, double tol,
+                 int m) const
+    {
+        return type == t && highPrecision == hp && relTol == tol && method == m && params == p && time == tm;
+    }
+    size_t bytes() const { return sizeof(double) * (size_t)(time.size() + 2 * std::get<1>(result).size()); }
+};
+
+std::mutex s_curveMutex;
+QVector<CurveMemoEntry> s_curveMemo;    // 按最近使用排序，最新的在前
+std::atomic<long long> s_curveHits(0);
+std::atomic<long long> s_curveMisses(0);
+
+size_t curveMemoBudget()
+{
+    return ((size_t)s_cacheLimitMB.load() << 20) / 4;
+}
+}
+
+ModelParams ModelSolver::toParams(const QMap<QString, double>& params)
+{
+    ModelParams p;
+    for (auto it = params.constBegin(); it != params.constEnd(); ++it) {
+        int id = ModelParams::indexOf(it.key().toUtf8().constData());
+        if (id >= 0) p.set((ModelParams::Id)id, it.value());
+    }
+    return p;
+}
+
+QMap<QString, double> ModelSolver::toMap(const ModelParams& params)
+{
+    QMap<QString, double> map;
+    for (int i = 0; i < ModelParams::Count; ++i) {
+        ModelParams::Id id = (ModelParams::Id)i;
+        if (params.has(id)) map.insert(QString::fromLatin1(ModelParams::name(id)), params.value(id));
+    }
+    return map;
+}
+
+ModelContext ModelSolver::buildContext(ModelType type, const ModelParams& params, bool highPrecision)
+{
+    ModelContext ctx;
+    ctx.type = type;
+    ctx.kf = params.value(ModelParams::Kf);
+    ctx.km = params.value(ModelParams::Km);
+    ctx.LfD = params.value(ModelParams::LfD);
+    ctx.rmD = params.value(ModelParams::RmD);
+    ctx.reD = params.value(ModelParams::ReD, 0.0);
+    ctx.omega1 = params.value(ModelParams::Omega1);
+    ctx.omega2 = params.value(ModelParams::Omega2);
+    ctx.lambda1 = params.value(ModelParams::Lambda1);
+    ctx.gamaD = params.value(ModelParams::GamaD, 0.0);
+    ctx.cD = params.value(ModelParams::CD, 0.0);
+    ctx.S = params.value(ModelParams::S, 0.0);
+    ctx.nf = (int)params.value(ModelParams::Nf, 4);
+
+    int N_param = (int)params.value(ModelParams::N, 4);
+    ctx.stehfestN = highPrecision ? N_param : 4;
+    if (ctx.stehfestN % 2 != 0) ctx.stehfestN = 4;
+    ctx.inversionMethod = inversionMethod();
+    ctx.inversionOrder = ModelInversion::defaultOrder(ctx.inversionMethod, highPrecision);
+
+    ctx.threadCount = s_inversionThreadCount.load();
+    // 拟合中 cD、S、gamaD 的扰动与试探步复用同一储层参数组的 PWD(z)
+    ctx.cacheResponse = s_cacheLimitMB.load() > 0;
+    return ctx;
+}
+
+ModelContext ModelSolver::buildContext(ModelType type, const QMap<QString, double>& params, bool highPrecision)
+{
+    return buildContext(type, toParams(params), highPrecision);
+}
+
+ModelCurveData ModelSolver::calculateTheoreticalCurve(ModelType type, const ModelParams& params,
+                                                      const QVector<double>& providedTime, bool highPrecision)
+{
+    return evaluateCurve(type, params, providedTime, highPrecision, 0.0);
+}
+
+ModelCurveData ModelSolver::calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params,
+                                                      const QVector<double>& providedTime, bool highPrecision)
+{
+    return evaluateCurve(type, toParams(params), providedTime, highPrecision, 0.0);
+}
+
+ModelCurveData ModelSolver::calculateInterpolatedCurve(ModelType type, const ModelParams& params,
+                                                       const QVector<double>& providedTime, bool highPrecision,
+                                                       double relTol)
+{
+    return evaluateCurve(type, params, providedTime, highPrecision, relTol > 0.0 ? relTol : DefaultGridTolerance);
+}
+
+ModelCurveData ModelSolver::calculateInterpolatedCurve(ModelType type, const QMap<QString, double>& params,
+                                                       const QVector<double>& providedTime, bool highPrecision,
+                                                       double relTol)
+{
+    return calculateInterpolatedCurve(type, toParams(params), providedTime, highPrecision, relTol);
+}
+
+ModelCurveData ModelSolver::evaluateCurve(ModelType type, const ModelParams& params,
+                                          const QVector<double>& providedTime, bool highPrecision, double relTol)
+{
+    // 未给出时间点时先生成默认网格，使缓存键随网格设置变化
+    const QVector<double> time = providedTime.isEmpty() ? generateTimeSteps(100, -3.0, 3.0) : providedTime;
+
+    // 参数与时间点未变 (重复刷新、被拒绝的试探步) 时直接返回上次的结果
+    const int method = s_inversionMethod.load();
+    const bool memo = s_cacheLimitMB.load() > 0;
+    if (memo) {
+        std::lock_guard<std::mutex> lock(s_curveMutex);
+        for (int i = 0; i < s_curveMemo.size(); ++i) {
+            if (s_curveMemo[i].matches(type, params, time, highPrecision, relTol, method)) {
+                if (i > 0) s_curveMemo.move(i, 0);
+                ++s_curveHits;
+                return s_curveMemo.first().result;
+            }
+        }
+    }
+    ModelCurveData result = computeCurve(type, params, time, highPrecision, relTol);
+    if (memo) {
+        ++s_curveMisses;
+        CurveMemoEntry entry{ type, params, time, highPrecision, relTol, method, result };
+        std::lock_guard<std::mutex> lock(s_curveMutex);
+        size_t budget = curveMemoBudget();
+        if (entry.bytes() <= budget) {
+            s_curveMemo.prepend(entry);
+            size_t used = 0;
+            for (int i = 0; i < s_curveMemo.size(); ++i) {
+                used += s_curveMemo[i].bytes();
+                if (i >= CurveMemoSize || used > budget) { s_curveMemo.resize(i); break; }
+            }
+        }
+    }
+    return result;
+}
+
+ModelCurveData ModelSolver::computeCurve(ModelType type, const ModelParams& params,
+                                         const QVector<double>& providedTime, bool highPrecision, double relTol)
+{
+    QVector<double> tPoints = providedTime;
+    if (tPoints.isEmpty()) {
+        tPoints = generateTimeSteps(100, -3.0, 3.0);
+    }
+
+    double phi = params.value(ModelParams::Phi, 0.05);
+    double mu = params.value(ModelParams::Mu, 0.5);
+    double B = params.value(ModelParams::B, 1.05);
+    double Ct = params.value(ModelParams::Ct, 5e-4);
+    double q = params.value(ModelParams::Q, 5.0);
+    double h = params.value(ModelParams::H, 20.0);
+    double kf = params.value(ModelParams::Kf, 1e-3);
+    double L = params.value(ModelParams::L, 1000.0);
+    std::vector<double> tD_vec;
+    tD_vec.reserve(tPoints.size());
+    for (double t : tPoints) {
+        tD_vec.push_back(14.4 * kf * t / (phi * mu * Ct * pow(L, 2)));
+    }
+
+    ModelContext ctx = buildContext(type, params, highPrecision);
+    // 压力导数 dp/dln(t) 与压力由同一组拉普拉斯值反演得到 (tD 与 t 成正比，dln tD = dln t)
+    std::vector<double> PD, Deriv_vec;
+    // 插值模式使用无因次主曲线缓存: phi、mu、Ct、q、B、h、L 不进入 ctx，它们的扰动只改变 tD 与 factor，
+    // 命中缓存时不做任何反演。请求点数少 (缓存未命中) 或网格达不到 relTol 时 masterCurve 返回空，逐点计算
+    std::shared_ptr<const MasterCurve> master;
+    if (relTol > 0.0) master = ModelCurveGrid::masterCurve(tD_vec, ctx, relTol);
+    if (master) {
+        master->evaluate(tD_vec, PD, Deriv_vec);
+    } else {
+        ModelKernel::calculatePDAndDerivative(tD_vec, ctx, PD, Deriv_vec);
+    }
+
+    double factor = 1.842e-3 * q * mu * B / (kf * h);
+    QVector<double> finalP(tPoints.size()), finalDP(tPoints.size());
+
+    for (int i = 0; i < tPoints.size(); ++i) {
+        finalP[i] = factor * PD[i];
+        finalDP[i] = factor * Deriv_vec[i];
+    }
+
+    return std::make_tuple(tPoints, finalP, finalDP);
+}
+
+QVector<double> ModelSolver::generateLogTimeSteps(int count, double startExp, double endExp)
+{
+    QVector<double> t;
+    t.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        double exponent = startExp + (endExp - startExp) * i / (count - 1);
+        t.append(pow(10.0, exponent));
+    }
+    return t;
+}
+
+QVector<double> ModelSolver::generateAlignedTimeSteps(int count, double startExp, double endExp)
+{
+    std::vector<double> t = ModelInversion::alignedTimes(count, startExp, endExp);
+    if (t.empty()) return generateLogTimeSteps(count, startExp, endExp);
+    return QVector<double>(t.begin(), t.end());
+}
+
+QVector<double> ModelSolver::generateTimeSteps(int count, double startExp, double endExp)
+{
+    if (s_alignedTimeSteps.load()) return generateAlignedTimeSteps(count, startExp, endExp);
+    return generateLogTimeSteps(count, startExp, endExp);
+}
+
+void ModelSolver::setAlignedTimeSteps(bool aligned)
+{
+    s_alignedTimeSteps.store(aligned);
+}
+
+bool ModelSolver::alignedTimeSteps()
+{
+    return s_alignedTimeSteps.load();
+}
+
+void ModelSolver::setInversionThreadCount(int count)
+{
+    s_inversionThreadCount.store(count < 0 ? 0 : count);
+}
+
+int ModelSolver::inversionThreadCount()
+{
+    return s_inversionThreadCount.load();
+}
+
+void ModelSolver::setInversionMethod(ModelInversion::Method method)
+{
+    s_inversionMethod.store((int)method);
+}
+
+ModelInversion::Method ModelSolver::inversionMethod()
+{
+    return (ModelInversion::Method)s_inversionMethod.load();
+}
+
+void ModelSolver::setCacheLimit(int megabytes)
+{
+    if (megabytes < 0) megabytes = 0;
+    s_cacheLimitMB.store(megabytes);
+    ModelResponseCache::setMemoryLimit((size_t)megabytes << 20);
+    std::lock_guard<std::mutex> lock(s_curveMutex);
+    if (megabytes == 0) s_curveMemo.clear();
+    size_t used = 0, budget = curveMemoBudget();
+    for (int i = 0; i < s_curveMemo.size(); ++i) {
+        used += s_curveMemo[i].bytes();
+        if (used > budget) { s_curveMemo.resize(i); break; }
+    }
+}
+
+int ModelSolver::cacheLimit()
+{
+    return s_cacheLimitMB.load();
+}
+
+ModelSolver::CacheStats ModelSolver::cacheStats()
+{
+    CacheStats s;
+    s.curveHits = s_curveHits.load();
+    s.curveMisses = s_curveMisses.load();
+    s.laplace = ModelResponseCache::stats();
+    return s;
+}
+
+void ModelSolver::resetCacheStats()
+{
+    s_curveHits = 0;
+    s_curveMisses = 0;
+    ModelResponseCache::resetStats();
+}
+
+void ModelSolver::clearCaches()
+{
+    {
+        std::lock_guard<std::mutex> lock(s_curveMutex);
+        s_curveMemo.clear();
+    }
+    ModelResponseCache::clear();
+    ModelCurveGrid::clearMasterCache();
+}
@@ -0,0 +1,111 @@
+/*
+ * 文件名: modelsolver.h
+ * 文件作用: 理论曲线计算服务头文件 (无界面)
+ * 功能描述:
+ * 1. 将界面/拟合模块使用的 QMap 参数表转换为计算内核的不可变上下文 ModelContext。
+ * 2. 提供可重入的理论曲线计算接口，供模型界面、拟合线程等多处同时调用。
+ * 3. 所有状态（包括精度设置）均通过参数传入，不依赖任何界面对象。
+ * 4. 反演并行线程数与反演算法为进程级配置，由系统设置页写入。
+ * 5. 观测点很多时可在自适应粗网格上计算后插值 (calculateInterpolatedCurve)。
+ * 6. 计算接口以 ModelParams 参数块为准，QMap 版本只在界面/文件边界做一次转换。
+ * 7. 最近的曲线结果按 (模型类型, 参数块, 时间点, 精度设置) 缓存，重复刷新直接返回，不做任何反演；
+ *    拉普拉斯值缓存 (ModelResponseCache) 的内存上限由系统设置页配置，0 表示关闭两级缓存。
+ * 8. 未给出时间点时使用默认时间网格 (generateTimeSteps): 对数均匀网格，系统设置页选择对齐网格时
+ *    改用与 Stehfest 节点对齐的网格 (generateAlignedTimeSteps)。
+ */
+
+#ifndef MODELSOLVER_H
+#define MODELSOLVER_H
+
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include <tuple>
+#include "modelkernel.h"
+#include "modelparams.h"
+#include "modelresponsecache.h"
+
+// 类型定义: <时间, 压力, 导数>
+using ModelCurveData = std::tuple<QVector<double>, QVector<double>, QVector<double>>;
+
+class ModelSolver
+{
+public:
+    using ModelType = ModelKernel::ModelType;
+
+    // QMap 参数表与参数块的互相转换 (未注册的参数名忽略)
+    static ModelParams toParams(const QMap<QString, double>& params);
+    static QMap<QString, double> toMap(const ModelParams& params);
+
+    // 根据参数块构造计算上下文
+    // highPrecision: 是否使用参数中的 Stehfest 项数 "N"，否则固定为 N=4；
+    //                其他反演算法取 ModelInversion::defaultOrder 的高/低精度阶数
+    static ModelContext buildContext(ModelType type, const ModelParams& params, bool highPrecision);
+    static ModelContext buildContext(ModelType type, const QMap<QString, double>& params, bool highPrecision);
+
+    // 计算理论曲线 (providedTime 为空时使用默认的 1e-3 ~ 1e3 对数时间序列)
+    static ModelCurveData calculateTheoreticalCurve(ModelType type, const ModelParams& params,
+                                                    const QVector<double>& providedTime = QVector<double>(),
+                                                    bool highPrecision = true);
+    static ModelCurveData calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params,
+                                                    const QVector<double>& providedTime = QVector<double>(),
+                                                    bool highPrecision = true);
+
+    // 与 calculateTheoreticalCurve 相同，但模型只在自适应对数粗网格上反演，再以对数-对数单调三次插值
+    // 映射到 providedTime (见 ModelCurveGrid)，压力与导数的相对插值误差不超过 relTol。
+    // 用于观测点很多的拟合残差计算，计算量与观测点数基本无关
+    static ModelCurveData calculateInterpolatedCurve(ModelType type, const ModelParams& params,
+                                                     const QVector<double>& providedTime, bool highPrecision = false,
+                                                     double relTol = DefaultGridTolerance);
+    static ModelCurveData calculateInterpolatedCurve(ModelType type, const QMap<QString, double>& params,
+                                                     const QVector<double>& providedTime, bool highPrecision = false,
+                                                     double relTol = DefaultGridTolerance);
+    static constexpr double DefaultGridTolerance = 1e-4;
+
+    // 生成对数时间步长
+    static QVector<double> generateLogTimeSteps(int count, double startExp, double endExp);
+    // 生成与 Stehfest 节点对齐的对数时间步长 (见 ModelInversion::alignedTimes)，点数与两端同上，
+    // 反演时相邻倍程的拉普拉斯值可复用
+    static QVector<double> generateAlignedTimeSteps(int count, double startExp, double endExp);
+    // 按系统设置生成默认时间步长 (默认对数均匀，设置为对齐网格时同 generateAlignedTimeSteps)
+    static QVector<double> generateTimeSteps(int count, double startExp, double endExp);
+
+    // 默认时间网格是否与 Stehfest 节点对齐 (由系统设置页配置，默认关闭)
+    static void setAlignedTimeSteps(bool aligned);
+    static bool alignedTimeSteps();
+
+    // 反演并行线程数 (由系统设置页配置，<=0 表示使用全部核心)
+    static void setInversionThreadCount(int count);
+    static int inversionThreadCount();
+
+    // 拉普拉斯反演算法 (由系统设置页配置，默认 Stehfest)
+    static void setInversionMethod(ModelInversion::Method method);
+    static ModelInversion::Method inversionMethod();
+
+    // 计算缓存的内存上限 (MB，由系统设置页配置，0 表示不缓存)
+    static void setCacheLimit(int megabytes);
+    static int cacheLimit();
+    // 曲线结果缓存的条数上限 (占用内存另计入上限的 1/4)
+    static const int CurveMemoSize = 16;
+
+    // 缓存统计: 曲线结果缓存与拉普拉斯值缓存的命中/未命中次数
+    struct CacheStats
+    {
+        long long curveHits = 0;
+        long long curveMisses = 0;
+        ModelResponseCache::Stats laplace;
+    };
+    static CacheStats cacheStats();
+    static void resetCacheStats();
+    static void clearCaches();
+
+private:
+    // relTol > 0 时使用自适应网格插值，否则逐点反演
+    static ModelCurveData evaluateCurve(ModelType type, const ModelParams& params,
+                                        const QVector<double>& providedTime, bool highPrecision, double relTol);
+    // 不经曲线结果缓存的实际计算
+    static ModelCurveData computeCurve(ModelType type, const ModelParams& params,
+                                       const QVector<double>& providedTime, bool highPrecision, double relTol);
+};
+
+#endif // MODELSOLVER_H
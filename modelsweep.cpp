@@ -0,0 +1,386 @@
+/*
+ * 文件名: modelsweep.cpp
+ * 文件作用: 多参数扫描引擎实现
+ * 功能描述:
+ * 1. 工况生成: 全组合按混合进制展开 (井储类参数在最内层)，拉丁超立方对每个参数独立打乱分层。
+ *    整数参数 (裂缝条数) 在生成取值时取整，计算、结果文件与包络使用同一个整数值。
+ * 2. 相邻且储层参数相同的工况组成一组，组内顺序计算以命中储层响应缓存，组间并行。
+ * 3. 每块计算完成后按工况顺序写入文件并累计包络，块内曲线以 float 暂存。
+ */
+
+#include "modelsweep.h"
+#include "modelthreadpool.h"
+
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <fstream>
+
+namespace {
+
+const char s_magic[4] = { 'W', 'T', 'S', 'W' };
+
+// 全组合的展开顺序: 储层参数在外层 (按 plan.axes 顺序)，井储类参数在内层，最后一个变化最快
+std::vector<int> cartesianOrder(const ModelSweep::Plan& plan)
+{
+    std::vector<int> order;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int j = 0; j < (int)plan.axes.size(); ++j) {
+            if (ModelSweep::isWellboreParameter(plan.axes[j].id) == (pass == 1)) order.push_back(j);
+        }
+    }
+    return order;
+}
+
+template<class T>
+void put(char*& out, T v)
+{
+    std::memcpy(out, &v, sizeof(T));
+    out += sizeof(T);
+}
+
+template<class T>
+T take(const char*& in)
+{
+    T v;
+    std::memcpy(&v, in, sizeof(T));
+    in += sizeof(T);
+    return v;
+}
+
+} // namespace
+
+std::vector<double> ModelSweep::Axis::levels() const
+{
+    std::vector<double> out;
+    if (!values.empty()) {
+        out = values;
+    } else if (count <= 1) {
+        out.push_back(min);
+    } else {
+        bool useLog = logScale && min > 0.0 && max > 0.0;
+        for (int i = 0; i < count; ++i) {
+            double u = (double)i / (count - 1);
+            out.push_back(useLog ? std::exp(std::log(min) + u * (std::log(max) - std::log(min)))
+                                 : min + u * (max - min));
+        }
+    }
+    if (ModelParams::isInteger(id)) {
+        // 取整后相同的取值只保留第一个 (否则全组合中出现完全相同的工况)
+        std::vector<double> unique;
+        for (double v : out) {
+            v = std::round(v);
+            if (std::find(unique.begin(), unique.end(), v) == unique.end()) unique.push_back(v);
+        }
+        out.swap(unique);
+    }
+    return out;
+}
+
+double ModelSweep::Axis::sample(double u) const
+{
+    const bool integer = ModelParams::isInteger(id);
+    if (!values.empty()) {
+        size_t k = (size_t)(u * values.size());
+        double v = values[std::min(k, values.size() - 1)];
+        return integer ? std::round(v) : v;
+    }
+    if (logScale && min > 0.0 && max > 0.0) {
+        double v = std::exp(std::log(min) + u * (std::log(max) - std::log(min)));
+        return integer ? std::round(v) : v;
+    }
+    if (integer) {
+        // [min, max] 内的各整数等分 [0, 1)；范围内没有整数时取最接近 min 的整数
+        double lo = std::ceil(std::min(min, max)), hi = std::floor(std::max(min, max));
+        if (hi < lo) return std::round(min);
+        return std::min(lo + std::floor(u * (hi - lo + 1.0)), hi);
+    }
+    return min + u * (max - min);
+}
+
+void ModelSweep::Envelope::reset(size_t timeCount)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    pMin.assign(timeCount, inf);
+    pMax.assign(timeCount, -inf);
+    pMean.assign(timeCount, 0.0);
+    dMin.assign(timeCount, inf);
+    dMax.assign(timeCount, -inf);
+    dMean.assign(timeCount, 0.0);
+    pCount.assign(timeCount, 0);
+    dCount.assign(timeCount, 0);
+}
+
+void ModelSweep::Envelope::add(const float* p, const float* d, size_t timeCount)
+{
+    for (size_t i = 0; i < timeCount; ++i) {
+        if (std::isfinite(p[i])) {
+            pMin[i] = std::min(pMin[i], (double)p[i]);
+            pMax[i] = std::max(pMax[i], (double)p[i]);
+            pMean[i] += (p[i] - pMean[i]) / (double)(++pCount[i]);
+        }
+        if (std::isfinite(d[i])) {
+            dMin[i] = std::min(dMin[i], (double)d[i]);
+            dMax[i] = std::max(dMax[i], (double)d[i]);
+            dMean[i] += (d[i] - dMean[i]) / (double)(++dCount[i]);
+        }
+    }
+}
+
+bool ModelSweep::isWellboreParameter(ModelParams::Id id)
+{
+    return id == ModelParams::CD || id == ModelParams::S || id == ModelParams::GamaD;
+}
+
+long long ModelSweep::caseCount(const Plan& plan)
+{
+    if (plan.sampling == LatinHypercube) return plan.axes.empty() ? 1 : std::max(plan.sampleCount, 0);
+    long long n = 1;
+    for (const Axis& axis : plan.axes) {
+        n *= (long long)axis.levels().size();
+        if (n > MaxCases) return MaxCases + 1;
+    }
+    return n;
+}
+
+std::vector<double> ModelSweep::generateCases(const Plan& plan)
+{
+    const long long n = caseCount(plan);
+    const int a = (int)plan.axes.size();
+    std::vector<double> cases;
+    if (n <= 0 || n > MaxCases) return cases;
+    cases.resize((size_t)n * a);
+    if (a == 0) return cases;
+
+    if (plan.sampling == LatinHypercube) {
+        // 每个参数的 n 个分层各取一个点，分层顺序对各参数独立打乱
+        std::mt19937 rng(plan.seed);
+        std::uniform_real_distribution<double> jitter(0.0, 1.0);
+        std::vector<int> perm((size_t)n);
+        for (int j = 0; j < a; ++j) {
+            std::iota(perm.begin(), perm.end(), 0);
+            std::shuffle(perm.begin(), perm.end(), rng);
+            for (long long i = 0; i < n; ++i) {
+                double u = (perm[(size_t)i] + jitter(rng)) / (double)n;
+                cases[(size_t)i * a + j] = plan.axes[j].sample(u);
+            }
+        }
+        return cases;
+    }
+
+    std::vector<std::vector<double>> levels(a);
+    for (int j = 0; j < a; ++j) levels[j] = plan.axes[j].levels();
+    std::vector<int> order = cartesianOrder(plan);
+    for (long long i = 0; i < n; ++i) {
+        long long rest = i;
+        for (int k = a - 1; k >= 0; --k) {
+            int j = order[k];
+            long long size = (long long)levels[j].size();
+            cases[(size_t)i * a + j] = levels[j][(size_t)(rest % size)];
+            rest /= size;
+        }
+    }
+    return cases;
+}
+
+ModelParams ModelSweep::caseParams(const Plan& plan, const double* values)
+{
+    ModelParams p = plan.base;
+    for (size_t j = 0; j < plan.axes.size(); ++j) p.set(plan.axes[j].id, values[j]);
+    p.updateDerived();
+    return p;
+}
+
+ModelSweep::Result ModelSweep::run(const Plan& plan, const CurveFunction& curve, const Options& options)
+{
+    Result result;
+    const int a = (int)plan.axes.size();
+    const int nt = (int)plan.time.size();
+    result.planned = caseCount(plan);
+    result.envelope.reset(nt);
+    std::vector<double> cases = generateCases(plan);
+    if (cases.empty() && a > 0) return result;
+    const long long n = result.planned;
+
+    // 相邻工况只有井储类参数不同时归为一组 (组内共享储层响应)
+    std::vector<long long> groupStart;
+    for (long long i = 0; i < n; ++i) {
+        bool fresh = (i == 0);
+        for (int j = 0; j < a && !fresh; ++j) {
+            if (isWellboreParameter(plan.axes[j].id)) continue;
+            fresh = cases[(size_t)i * a + j] != cases[(size_t)(i - 1) * a + j];
+        }
+        if (fresh) groupStart.push_back(i);
+    }
+    groupStart.push_back(n);
+    result.groups = (long long)groupStart.size() - 1;
+
+    std::ofstream out;
+    if (!options.outputPath.empty()) {
+        out.open(options.outputPath, std::ios::binary | std::ios::trunc);
+        std::vector<char> header(ModelSweepFile::headerSize(a, nt));
+        char* w = header.data();
+        std::memcpy(w, s_magic, 4);
+        w += 4;
+        put<uint32_t>(w, ModelSweepFile::Version);
+        put<int32_t>(w, (int32_t)plan.type);
+        put<uint32_t>(w, (uint32_t)a);
+        put<uint32_t>(w, (uint32_t)nt);
+        put<uint32_t>(w, (uint32_t)n);
+        put<uint32_t>(w, (uint32_t)plan.sampling);
+        put<uint32_t>(w, 0u);
+        for (const Axis& axis : plan.axes) put<int32_t>(w, (int32_t)axis.id);
+        for (double t : plan.time) put<double>(w, t);
+        out.write(header.data(), (std::streamsize)header.size());
+        if (!out) {
+            result.ioError = true;
+            return result;
+        }
+    }
+
+    // 每块至少有与线程数相同的组，且不少于 blockCases 个工况
+    const int threads = ModelThreadPool::resolveThreadCount(options.threadCount);
+    const long long blockCases = options.blockCases > 0 ? options.blockCases : 4LL * threads;
+    const size_t recordBytes = ModelSweepFile::recordSize(a, nt);
+    std::vector<float> pBlock, dBlock;
+    std::vector<char> okBlock;
+    std::vector<char> record(recordBytes);
+
+    size_t g0 = 0;
+    const size_t groupCount = groupStart.size() - 1;
+    while (g0 < groupCount) {
+        if (options.cancel && options.cancel->load()) {
+            result.cancelled = true;
+            break;
+        }
+        size_t g1 = g0;
+        while (g1 < groupCount && ((long long)(g1 - g0) < threads || groupStart[g1] - groupStart[g0] < blockCases)) ++g1;
+        const long long c0 = groupStart[g0];
+        const long long c1 = groupStart[g1];
+        const size_t len = (size_t)(c1 - c0);
+        pBlock.assign(len * nt, std::numeric_limits<float>::quiet_NaN());
+        dBlock.assign(len * nt, std::numeric_limits<float>::quiet_NaN());
+        okBlock.assign(len, 0);
+
+        ModelThreadPool::instance().parallelFor((int)(g1 - g0), threads, [&](int g) {
+            std::vector<double> p, d;
+            for (long long i = groupStart[g0 + g]; i < groupStart[g0 + g + 1]; ++i) {
+                ModelParams params = caseParams(plan, cases.data() + (size_t)i * a);
+                p.clear();
+                d.clear();
+                if (!curve(params, p, d) || (int)p.size() != nt || (int)d.size() != nt) continue;
+                size_t row = (size_t)(i - c0);
+                for (int k = 0; k < nt; ++k) {
+                    pBlock[row * nt + k] = (float)p[k];
+                    dBlock[row * nt + k] = (float)d[k];
+                }
+                okBlock[row] = 1;
+            }
+        });
+
+        for (size_t row = 0; row < len; ++row) {
+            const float* p = pBlock.data() + row * nt;
+            const float* d = dBlock.data() + row * nt;
+            if (okBlock[row]) result.envelope.add(p, d, nt);
+            else ++result.failed;
+            if (out.is_open()) {
+                char* w = record.data();
+                put<uint32_t>(w, (uint32_t)(c0 + row));
+                put<uint32_t>(w, okBlock[row] ? 1u : 0u);
+                for (int j = 0; j < a; ++j) put<double>(w, cases[(size_t)(c0 + row) * a + j]);
+                std::memcpy(w, p, sizeof(float) * nt);
+                std::memcpy(w + sizeof(float) * nt, d, sizeof(float) * nt);
+                out.write(record.data(), (std::streamsize)recordBytes);
+            }
+        }
+        if (out.is_open() && !out) {
+            result.ioError = true;
+            break;
+        }
+        result.completed = c1;
+        if (options.progress) options.progress(result.completed, n);
+        g0 = g1;
+    }
+    return result;
+}
+
+size_t ModelSweepFile::headerSize(int axisCount, int timeCount)
+{
+    return 4 + 7 * sizeof(uint32_t) + sizeof(int32_t) * axisCount + sizeof(double) * timeCount;
+}
+
+size_t ModelSweepFile::recordSize(int axisCount, int timeCount)
+{
+    return 2 * sizeof(uint32_t) + sizeof(double) * axisCount + 2 * sizeof(float) * timeCount;
+}
+
+bool ModelSweepFile::open(const std::string& path)
+{
+    m_recordSize = 0;
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    const long long fileSize = (long long)in.tellg();
+    in.seekg(0);
+
+    char fixed[4 + 7 * sizeof(uint32_t)];
+    if (!in.read(fixed, sizeof(fixed)) || std::memcmp(fixed, s_magic, 4) != 0) return false;
+    const char* r = fixed + 4;
+    if (take<uint32_t>(r) != Version) return false;
+    m_modelType = take<int32_t>(r);
+    const int a = (int)take<uint32_t>(r);
+    const int nt = (int)take<uint32_t>(r);
+    m_planned = take<uint32_t>(r);
+    m_sampling = (int)take<uint32_t>(r);
+    if (a < 0 || a > ModelParams::Count || nt <= 0) return false;
+
+    m_axisIds.resize(a);
+    m_time.resize(nt);
+    std::vector<int32_t> ids(a);
+    if (a > 0 && !in.read((char*)ids.data(), sizeof(int32_t) * a)) return false;
+    if (!in.read((char*)m_time.data(), sizeof(double) * nt)) return false;
+    for (int j = 0; j < a; ++j) m_axisIds[j] = ids[j];
+
+    m_headerSize = headerSize(a, nt);
+    m_recordSize = recordSize(a, nt);
+    m_caseCount = (fileSize - (long long)m_headerSize) / (long long)m_recordSize;
+    if (m_caseCount < 0) m_caseCount = 0;
+    m_path = path;
+    return true;
+}
+
+bool ModelSweepFile::readCase(long long index, std::vector<double>* values, std::vector<double>* p,
+                              std::vector<double>* d) const
+{
+    if (!isOpen() || index < 0 || index >= m_caseCount) return false;
+    std::ifstream in(m_path, std::ios::binary);
+    std::vector<char> record(m_recordSize);
+    in.seekg((std::streamoff)(m_headerSize + (size_t)index * m_recordSize));
+    if (!in.read(record.data(), (std::streamsize)m_recordSize)) return false;
+
+    const int a = (int)m_axisIds.size();
+    const int nt = (int)m_time.size();
+    const char* r = record.data();
+    take<uint32_t>(r);
+    bool ok = take<uint32_t>(r) == 1u;
+    if (values) {
+        values->resize(a);
+        for (int j = 0; j < a; ++j) (*values)[j] = take<double>(r);
+    } else {
+        r += sizeof(double) * a;
+    }
+    if (p) {
+        p->resize(nt);
+        for (int k = 0; k < nt; ++k) (*p)[k] = take<float>(r);
+    } else {
+        r += sizeof(float) * nt;
+    }
+    if (d) {
+        d->resize(nt);
+        for (int k = 0; k < nt; ++k) (*d)[k] = take<float>(r);
+    }
+    return ok;
+}
@@ -0,0 +1,153 @@
+/*
+ * 文件名: modelsweep.h
+ * 文件作用: 多参数扫描 (设计研究) 引擎头文件 (纯 C++ 实现，无 Qt 依赖)
+ * 功能描述:
+ * 1. 2~5 个参数同时扫描: 全组合 (Cartesian) 或拉丁超立方抽样 (LatinHypercube)，
+ *    每个参数给出范围 (线性/对数等分) 或显式取值列表。
+ * 2. 曲线计算由调用方传入 (界面使用 ModelSolver，有因次)，引擎只负责生成工况、调度与汇总:
+ *    只改变井储/表皮/应力敏感 (cD、S、gamaD) 的工况排在最内层并在同一线程内顺序计算，
+ *    同组工况的储层响应 PWD(z) 经 ModelResponseCache 复用；各组分配到内核线程池并行。
+ * 3. 结果按工况顺序分块写入紧凑二进制文件 (ModelSweepFile 读取)，内存中只保留一个块，
+ *    同时累计各时间点压力/导数的最小、最大与平均值 (包络)，界面不必把全部曲线放进图表。
+ * 4. 支持取消 (已写入的工况保留在文件中) 与进度回调。
+ */
+
+#ifndef MODELSWEEP_H
+#define MODELSWEEP_H
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <functional>
+
+#include "modelkernel.h"
+#include "modelparams.h"
+
+class ModelSweep
+{
+public:
+    enum Sampling {
+        Cartesian = 0,      // 全组合
+        LatinHypercube      // 拉丁超立方抽样
+    };
+
+    // 一个扫描参数: values 非空时使用显式取值，否则在 [min, max] 内取 count 个点 (logScale 为对数等分)。
+    // 整数参数 (ModelParams::isInteger，如裂缝条数) 的取值取整，重复的取值只保留一个
+    struct Axis
+    {
+        ModelParams::Id id = ModelParams::Kf;
+        double min = 0.0;
+        double max = 0.0;
+        int count = 0;
+        bool logScale = false;
+        std::vector<double> values;
+
+        // 全组合使用的取值
+        std::vector<double> levels() const;
+        // u ∈ [0, 1) 对应的取值 (拉丁超立方使用；整数参数在范围内的各整数上等概率)
+        double sample(double u) const;
+    };
+
+    struct Plan
+    {
+        ModelKernel::ModelType type = ModelKernel::Model_1;
+        ModelParams base;               // 未扫描参数的取值
+        std::vector<Axis> axes;
+        Sampling sampling = Cartesian;
+        int sampleCount = 100;          // 拉丁超立方的工况数
+        unsigned seed = 1;              // 拉丁超立方的随机种子 (相同种子工况相同)
+        std::vector<double> time;       // 曲线时间点 (与 CurveFunction 约定的单位一致)
+    };
+
+    // 计算一条曲线: 输出与 time 等长的压力与导数，失败时返回 false (该工况记为失败)
+    using CurveFunction = std::function<bool(const ModelParams& params, std::vector<double>& p,
+                                             std::vector<double>& d)>;
+
+    // 各时间点的包络 (只统计有限值)
+    struct Envelope
+    {
+        std::vector<double> pMin, pMax, pMean;
+        std::vector<double> dMin, dMax, dMean;
+        std::vector<long long> pCount, dCount;
+
+        void reset(size_t timeCount);
+        void add(const float* p, const float* d, size_t timeCount);
+    };
+
+    struct Options
+    {
+        std::string outputPath;                     // 二进制结果文件 (为空时只计算包络)
+        int threadCount = 0;                        // 参与计算的线程数，<=0 表示全部核心
+        int blockCases = 0;                         // 每块的工况数，<=0 时按线程数自动选择
+        const std::atomic<bool>* cancel = nullptr;  // 非空且为真时在当前块结束后停止
+        std::function<void(long long done, long long total)> progress; // 每块写入后在调用线程回调
+    };
+
+    struct Result
+    {
+        long long planned = 0;      // 计划工况数
+        long long completed = 0;    // 已写入的工况数 (含失败)
+        long long failed = 0;       // 曲线计算失败的工况数
+        long long groups = 0;       // 共享储层响应的工况组数
+        bool cancelled = false;
+        bool ioError = false;       // 结果文件无法写入
+        Envelope envelope;
+    };
+
+    // 单次扫描的工况数上限
+    static const long long MaxCases = 1000000;
+
+    static long long caseCount(const Plan& plan);
+    // 全部工况的参数取值 (caseCount × axes.size()，按行存放，列顺序与 plan.axes 相同)
+    static std::vector<double> generateCases(const Plan& plan);
+    // 某工况的完整参数块 (base + 扫描取值，并更新 LfD 等联动参数)
+    static ModelParams caseParams(const Plan& plan, const double* values);
+    // 只进入井储/表皮外层修正或反演后修正的参数 (相同储层响应可复用)
+    static bool isWellboreParameter(ModelParams::Id id);
+
+    // 执行扫描 (阻塞直到完成或取消)
+    static Result run(const Plan& plan, const CurveFunction& curve, const Options& options);
+};
+
+// 扫描结果文件 (小端，native double/float):
+//   文件头: "WTSW" | uint32 版本 | int32 模型类型 | uint32 参数数 A | uint32 时间点数 T | uint32 计划工况数
+//           | uint32 抽样方式 | uint32 保留 | int32 参数下标[A] | double 时间[T]
+//   工况记录 (定长，按工况顺序): uint32 工况序号 | uint32 状态 (1 = 成功) | double 参数值[A]
+//           | float 压力[T] | float 导数[T]
+class ModelSweepFile
+{
+public:
+    static const unsigned Version = 1;
+
+    bool open(const std::string& path);
+    bool isOpen() const { return m_recordSize > 0; }
+
+    int modelType() const { return m_modelType; }
+    int sampling() const { return m_sampling; }
+    long long plannedCases() const { return m_planned; }
+    // 文件中完整的工况记录数 (取消时少于计划数)
+    long long caseCount() const { return m_caseCount; }
+    const std::vector<int>& axisIds() const { return m_axisIds; }
+    const std::vector<double>& time() const { return m_time; }
+
+    // 读取第 index 条记录; values/p/d 可为空 (只读需要的部分)，返回该工况是否计算成功
+    bool readCase(long long index, std::vector<double>* values, std::vector<double>* p = nullptr,
+                  std::vector<double>* d = nullptr) const;
+
+    // 写入端使用的文件头/记录长度
+    static size_t headerSize(int axisCount, int timeCount);
+    static size_t recordSize(int axisCount, int timeCount);
+
+private:
+    std::string m_path;
+    int m_modelType = 0;
+    int m_sampling = 0;
+    long long m_planned = 0;
+    long long m_caseCount = 0;
+    std::vector<int> m_axisIds;
+    std::vector<double> m_time;
+    size_t m_headerSize = 0;
+    size_t m_recordSize = 0;
+};
+
+#endif // MODELSWEEP_H
@@ -0,0 +1,549 @@
+/*
+ * 文件名: modelsweepdialog.cpp
+ * 文件作用: 多参数扫描对话框实现
+ * 功能描述:
+ * 1. 参数表: 每行一个扫描参数 (参数名、最小值、最大值、点数、对数等分、取值列表)。
+ * 2. 扫描在 QtConcurrent 线程中调用 ModelSweep::run，曲线由 ModelSolver 计算 (有因次，与模型页一致)，
+ *    工况组之间由内核线程池并行；进度与结束通知经排队信号回到界面线程。
+ * 3. 结束后绘制包络；曲线族页每次最多读取"最多曲线数"条曲线，按变化参数排序显示。
+ * 4. 可打开以前保存的结果文件 (重新统计包络)。
+ */
+
+#include "modelsweepdialog.h"
+#include "ui_modelsweepdialog.h"
+#include "modelparameter.h"
+#include "chartwidget.h"
+
+#include <cmath>
+#include <algorithm>
+#include <QtConcurrent>
+#include <QComboBox>
+#include <QFile>
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QDateTime>
+
+namespace {
+enum AxisColumn { ColName = 0, ColMin, ColMax, ColCount, ColLog, ColValues, ColumnCount };
+const int MaxAxes = 5;
+
+QVector<double> parseValues(const QString& text)
+{
+    QVector<double> values;
+    QString cleanText = text;
+    cleanText.replace("，", ",");
+    for (const QString& part : cleanText.split(",", Qt::SkipEmptyParts)) {
+        bool ok;
+        double v = part.trimmed().toDouble(&ok);
+        if (ok) values.append(v);
+    }
+    return values;
+}
+
+std::string localPath(const QString& path)
+{
+    return QFile::encodeName(path).toStdString();
+}
+}
+
+ModelSweepDialog::ModelSweepDialog(ModelKernel::ModelType type, const QMap<QString, double>& baseParams,
+                                   const QMap<QString, QVector<double>>& presetValues, const QVector<double>& time,
+                                   bool highPrecision, QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::ModelSweepDialog)
+    , m_type(type)
+    , m_baseParams(baseParams)
+    , m_time(time)
+    , m_highPrecision(highPrecision)
+    , m_cancelRequested(false)
+    , m_isRunning(false)
+{
+    ui->setupUi(this);
+    ui->splitter->setSizes(QList<int>{460, 740});
+
+    QStringList headers;
+    headers << "参数" << "最小值" << "最大值" << "点数" << "对数" << "取值列表";
+    ui->tableAxes->setColumnCount(ColumnCount);
+    ui->tableAxes->setHorizontalHeaderLabels(headers);
+    ui->tableAxes->horizontalHeader()->setSectionResizeMode(ColValues, QHeaderView::Stretch);
+    ui->tableAxes->verticalHeader()->setVisible(false);
+
+    setupLogPlot(ui->chartEnvelope->getPlot());
+    setupLogPlot(ui->chartFamily->getPlot());
+    ui->chartEnvelope->setTitle("压力/导数包络");
+    ui->chartFamily->setTitle("曲线族");
+
+    // 模型页中给出多个取值的参数直接作为扫描参数 (保留显式取值)
+    for (auto it = presetValues.constBegin(); it != presetValues.constEnd(); ++it) {
+        if (ui->tableAxes->rowCount() >= MaxAxes) break;
+        const QVector<double>& v = it.value();
+        if (v.size() < 2 || !sweepableParameters().contains(it.key())) continue;
+        auto range = std::minmax_element(v.begin(), v.end());
+        addAxisRow(it.key(), *range.first, *range.second, v.size(), false, v);
+    }
+    if (ui->tableAxes->rowCount() == 0) {
+        double kf = baseParams.value("kf", 1e-3);
+        addAxisRow("kf", kf / 10.0, kf * 10.0, 5, true, QVector<double>());
+    }
+
+    QString defaultDir = ModelParameter::instance()->getProjectPath();
+    if (defaultDir.isEmpty()) defaultDir = ".";
+    ui->lineOutput->setText(defaultDir + "/sweep_" + QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss") + ".wtsw");
+
+    connect(this, &ModelSweepDialog::sigProgress, this, &ModelSweepDialog::onProgress, Qt::QueuedConnection);
+    connect(&m_watcher, &QFutureWatcher<ModelSweep::Result>::finished, this, &ModelSweepDialog::onSweepFinished);
+    connect(ui->btnAddAxis, &QPushButton::clicked, this, &ModelSweepDialog::onAddAxis);
+    connect(ui->btnRemoveAxis, &QPushButton::clicked, this, &ModelSweepDialog::onRemoveAxis);
+    connect(ui->btnBrowse, &QPushButton::clicked, this, &ModelSweepDialog::onBrowse);
+    connect(ui->btnRun, &QPushButton::clicked, this, &ModelSweepDialog::onRunClicked);
+    connect(ui->btnOpen, &QPushButton::clicked, this, &ModelSweepDialog::onOpenResult);
+    connect(ui->btnClose, &QPushButton::clicked, this, &ModelSweepDialog::reject);
+    connect(ui->tableAxes, &QTableWidget::itemChanged, this, &ModelSweepDialog::onPlanChanged);
+    connect(ui->comboSampling, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ModelSweepDialog::onPlanChanged);
+    connect(ui->spinSamples, QOverload<int>::of(&QSpinBox::valueChanged), this, &ModelSweepDialog::onPlanChanged);
+    connect(ui->comboFamilyAxis, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ModelSweepDialog::updateFamilyPlot);
+    connect(ui->spinReference, QOverload<int>::of(&QSpinBox::valueChanged), this, &ModelSweepDialog::updateFamilyPlot);
+    connect(ui->spinPageSize, QOverload<int>::of(&QSpinBox::valueChanged), this, &ModelSweepDialog::updateFamilyPlot);
+
+    ui->btnRun->setAutoDefault(false);
+    ui->btnClose->setAutoDefault(false);
+    onPlanChanged();
+}
+
+ModelSweepDialog::~ModelSweepDialog()
+{
+    m_cancelRequested = true;
+    m_watcher.waitForFinished();
+    delete ui;
+}
+
+QStringList ModelSweepDialog::sweepableParameters()
+{
+    return QStringList{ "kf", "km", "L", "Lf", "nf", "rmD", "reD", "omega1", "omega2", "lambda1", "gamaD",
+                        "cD", "S", "phi", "mu", "B", "Ct", "q", "h" };
+}
+
+void ModelSweepDialog::setupLogPlot(MouseZoom* plot)
+{
+    QSharedPointer<QCPAxisTickerLog> logTicker(new QCPAxisTickerLog);
+    plot->xAxis->setScaleType(QCPAxis::stLogarithmic); plot->xAxis->setTicker(logTicker);
+    plot->yAxis->setScaleType(QCPAxis::stLogarithmic); plot->yAxis->setTicker(logTicker);
+    plot->xAxis->setNumberFormat("eb"); plot->xAxis->setNumberPrecision(0);
+    plot->yAxis->setNumberFormat("eb"); plot->yAxis->setNumberPrecision(0);
+    plot->xAxis->setLabel("时间 Time (h)");
+    plot->yAxis->setLabel("压力 & 导数 Pressure & Derivative (MPa)");
+    plot->xAxis->grid()->setSubGridVisible(true); plot->yAxis->grid()->setSubGridVisible(true);
+    plot->xAxis->setRange(1e-3, 1e3); plot->yAxis->setRange(1e-3, 1e2);
+    plot->legend->setVisible(true);
+    plot->legend->setFont(QFont("Arial", 9));
+    plot->legend->setBrush(QBrush(QColor(255, 255, 255, 200)));
+}
+
+void ModelSweepDialog::addAxisRow(const QString& name, double minValue, double maxValue, int count, bool logScale,
+                                  const QVector<double>& values)
+{
+    QSignalBlocker blocker(ui->tableAxes);
+    int row = ui->tableAxes->rowCount();
+    ui->tableAxes->insertRow(row);
+
+    QComboBox* combo = new QComboBox();
+    combo->addItems(sweepableParameters());
+    combo->setCurrentText(name);
+    connect(combo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ModelSweepDialog::onPlanChanged);
+    ui->tableAxes->setCellWidget(row, ColName, combo);
+
+    ui->tableAxes->setItem(row, ColMin, new QTableWidgetItem(QString::number(minValue, 'g', 8)));
+    ui->tableAxes->setItem(row, ColMax, new QTableWidgetItem(QString::number(maxValue, 'g', 8)));
+    ui->tableAxes->setItem(row, ColCount, new QTableWidgetItem(QString::number(count)));
+    QTableWidgetItem* logItem = new QTableWidgetItem();
+    logItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsUserCheckable);
+    logItem->setCheckState(logScale ? Qt::Checked : Qt::Unchecked);
+    ui->tableAxes->setItem(row, ColLog, logItem);
+    QStringList text;
+    for (double v : values) text << QString::number(v, 'g', 8);
+    ui->tableAxes->setItem(row, ColValues, new QTableWidgetItem(text.join(", ")));
+}
+
+void ModelSweepDialog::onAddAxis()
+{
+    if (ui->tableAxes->rowCount() >= MaxAxes) {
+        QMessageBox::information(this, "提示", QString("最多同时扫描 %1 个参数").arg(MaxAxes));
+        return;
+    }
+    // 默认取下一个未使用的参数，范围为当前值的 0.5 ~ 2 倍
+    QStringList used;
+    for (int r = 0; r < ui->tableAxes->rowCount(); ++r) {
+        used << qobject_cast<QComboBox*>(ui->tableAxes->cellWidget(r, ColName))->currentText();
+    }
+    QString name;
+    for (const QString& p : sweepableParameters()) {
+        if (!used.contains(p)) { name = p; break; }
+    }
+    double v = m_baseParams.value(name, 1.0);
+    addAxisRow(name, v * 0.5, v * 2.0, 3, false, QVector<double>());
+    onPlanChanged();
+}
+
+void ModelSweepDialog::onRemoveAxis()
+{
+    int row = ui->tableAxes->currentRow();
+    if (row < 0) row = ui->tableAxes->rowCount() - 1;
+    if (row < 0) return;
+    ui->tableAxes->removeRow(row);
+    onPlanChanged();
+}
+
+void ModelSweepDialog::onBrowse()
+{
+    QString path = QFileDialog::getSaveFileName(this, "扫描结果文件", ui->lineOutput->text(), "Sweep Files (*.wtsw)");
+    if (!path.isEmpty()) ui->lineOutput->setText(path);
+}
+
+bool ModelSweepDialog::buildPlan(ModelSweep::Plan& plan, QString* error) const
+{
+    plan = ModelSweep::Plan();
+    plan.type = m_type;
+    plan.base = ModelSolver::toParams(m_baseParams);
+    plan.time.assign(m_time.begin(), m_time.end());
+    plan.sampling = ui->comboSampling->currentIndex() == 1 ? ModelSweep::LatinHypercube : ModelSweep::Cartesian;
+    plan.sampleCount = ui->spinSamples->value();
+    plan.seed = (unsigned)ui->spinSeed->value();
+
+    for (int r = 0; r < ui->tableAxes->rowCount(); ++r) {
+        QString name = qobject_cast<QComboBox*>(ui->tableAxes->cellWidget(r, ColName))->currentText();
+        ModelSweep::Axis axis;
+        axis.id = (ModelParams::Id)ModelParams::indexOf(name.toUtf8().constData());
+        for (const ModelSweep::Axis& other : plan.axes) {
+            if (other.id == axis.id) {
+                if (error) *error = QString("参数 %1 重复").arg(name);
+                return false;
+            }
+        }
+        auto cell = [&](int col) { QTableWidgetItem* item = ui->tableAxes->item(r, col); return item ? item->text() : QString(); };
+        axis.min = cell(ColMin).toDouble();
+        axis.max = cell(ColMax).toDouble();
+        axis.count = cell(ColCount).toInt();
+        axis.logScale = ui->tableAxes->item(r, ColLog) && ui->tableAxes->item(r, ColLog)->checkState() == Qt::Checked;
+        QVector<double> values = parseValues(cell(ColValues));
+        axis.values.assign(values.begin(), values.end());
+        if (axis.values.empty() && axis.count < 1) {
+            if (error) *error = QString("参数 %1 的点数至少为 1").arg(name);
+            return false;
+        }
+        if (axis.logScale && axis.values.empty() && (axis.min <= 0.0 || axis.max <= 0.0)) {
+            if (error) *error = QString("参数 %1 对数等分时范围必须为正").arg(name);
+            return false;
+        }
+        plan.axes.push_back(axis);
+    }
+    if (plan.axes.empty()) {
+        if (error) *error = "请至少添加一个扫描参数";
+        return false;
+    }
+    if (ModelSweep::caseCount(plan) > ModelSweep::MaxCases) {
+        if (error) *error = QString("工况数超过上限 %1").arg(ModelSweep::MaxCases);
+        return false;
+    }
+    return true;
+}
+
+void ModelSweepDialog::onPlanChanged()
+{
+    ModelSweep::Plan plan;
+    QString error;
+    if (buildPlan(plan, &error)) {
+        ui->labelCases->setText(QString("计划工况数: %1").arg(ModelSweep::caseCount(plan)));
+    } else {
+        ui->labelCases->setText(QString("计划工况数: - (%1)").arg(error));
+    }
+    ui->spinSamples->setEnabled(plan.sampling == ModelSweep::LatinHypercube);
+    ui->spinSeed->setEnabled(plan.sampling == ModelSweep::LatinHypercube);
+}
+
+void ModelSweepDialog::onRunClicked()
+{
+    if (m_isRunning) {
+        m_cancelRequested = true;
+        ui->btnRun->setEnabled(false);
+        ui->btnRun->setText("正在取消...");
+        return;
+    }
+
+    ModelSweep::Plan plan;
+    QString error;
+    if (!buildPlan(plan, &error)) {
+        QMessageBox::warning(this, "参数错误", error);
+        return;
+    }
+    QString path = ui->lineOutput->text().trimmed();
+    if (path.isEmpty()) {
+        QMessageBox::warning(this, "参数错误", "请指定结果文件");
+        return;
+    }
+
+    ModelSweep::Options options;
+    options.outputPath = localPath(path);
+    options.threadCount = ModelSolver::inversionThreadCount();
+    options.cancel = &m_cancelRequested;
+    options.progress = [this](long long done, long long total) { emit sigProgress(done, total); };
+
+    // 曲线与模型页完全相同 (有因次，经 ModelSolver 的两级缓存)
+    const ModelKernel::ModelType type = m_type;
+    const bool highPrecision = m_highPrecision;
+    const QVector<double> time = m_time;
+    ModelSweep::CurveFunction curve = [type, highPrecision, time](const ModelParams& params, std::vector<double>& p,
+                                                                  std::vector<double>& d) {
+        ModelCurveData res = ModelSolver::calculateTheoreticalCurve(type, params, time, highPrecision);
+        p.assign(std::get<1>(res).begin(), std::get<1>(res).end());
+        d.assign(std::get<2>(res).begin(), std::get<2>(res).end());
+        return true;
+    };
+
+    m_file = ModelSweepFile();
+    m_caseValues.clear();
+    m_runningPath = path;
+    m_cancelRequested = false;
+    m_isRunning = true;
+    ui->progressBar->setRange(0, 1000);
+    ui->progressBar->setValue(0);
+    ui->btnRun->setText("取消扫描");
+    ui->btnOpen->setEnabled(false);
+    ui->groupAxes->setEnabled(false);
+    ui->groupSampling->setEnabled(false);
+
+    m_watcher.setFuture(QtConcurrent::run([plan, curve, options]() { return ModelSweep::run(plan, curve, options); }));
+}
+
+void ModelSweepDialog::onProgress(qint64 done, qint64 total)
+{
+    if (total > 0) ui->progressBar->setValue((int)(1000 * done / total));
+    ui->labelCases->setText(QString("已完成 %1 / %2").arg(done).arg(total));
+}
+
+void ModelSweepDialog::onSweepFinished()
+{
+    ModelSweep::Result result = m_watcher.result();
+    m_isRunning = false;
+    m_cancelRequested = false;
+    ui->btnRun->setEnabled(true);
+    ui->btnRun->setText("开始扫描");
+    ui->btnOpen->setEnabled(true);
+    ui->groupAxes->setEnabled(true);
+    ui->groupSampling->setEnabled(true);
+
+    if (result.ioError) {
+        QMessageBox::warning(this, "扫描失败", "结果文件无法写入: " + m_runningPath);
+        return;
+    }
+    ui->labelCases->setText(QString("%1: %2 / %3 个工况 (%4 组)，失败 %5")
+                                .arg(result.cancelled ? "已取消" : "扫描完成")
+                                .arg(result.completed).arg(result.planned).arg(result.groups).arg(result.failed));
+    plotEnvelope(result.envelope, m_time);
+    loadResult(m_runningPath);
+}
+
+void ModelSweepDialog::onOpenResult()
+{
+    QString path = QFileDialog::getOpenFileName(this, "打开扫描结果", ui->lineOutput->text(), "Sweep Files (*.wtsw)");
+    if (path.isEmpty()) return;
+    if (!loadResult(path)) {
+        QMessageBox::warning(this, "打开失败", "不是有效的扫描结果文件: " + path);
+        return;
+    }
+
+    // 逐条读取重新统计包络 (每次只在内存中保留一条曲线)
+    const std::vector<double>& t = m_file.time();
+    ModelSweep::Envelope env;
+    env.reset(t.size());
+    std::vector<double> p, d;
+    std::vector<float> pf(t.size()), df(t.size());
+    long long failed = 0;
+    for (long long i = 0; i < m_file.caseCount(); ++i) {
+        if (!m_file.readCase(i, nullptr, &p, &d)) { ++failed; continue; }
+        std::copy(p.begin(), p.end(), pf.begin());
+        std::copy(d.begin(), d.end(), df.begin());
+        env.add(pf.data(), df.data(), t.size());
+    }
+    ui->labelCases->setText(QString("结果文件: %1 / %2 个工况，失败 %3")
+                                .arg(m_file.caseCount()).arg(m_file.plannedCases()).arg(failed));
+    plotEnvelope(env, QVector<double>(t.begin(), t.end()));
+}
+
+void ModelSweepDialog::plotEnvelope(const ModelSweep::Envelope& env, const QVector<double>& time)
+{
+    MouseZoom* plot = ui->chartEnvelope->getPlot();
+    plot->clearGraphs();
+
+    struct Band { const std::vector<double>* lo; const std::vector<double>* hi; const std::vector<double>* mean;
+                  const std::vector<long long>* count; QColor color; QString name; };
+    const Band bands[] = {
+        { &env.pMin, &env.pMax, &env.pMean, &env.pCount, QColor(Qt::red), "压力" },
+        { &env.dMin, &env.dMax, &env.dMean, &env.dCount, QColor(Qt::blue), "压力导数" },
+    };
+    for (const Band& band : bands) {
+        QVector<double> t, lo, hi, mean;
+        for (int i = 0; i < time.size() && i < (int)band.count->size(); ++i) {
+            if ((*band.count)[i] == 0) continue;
+            t.append(time[i]);
+            lo.append((*band.lo)[i]);
+            hi.append((*band.hi)[i]);
+            mean.append((*band.mean)[i]);
+        }
+        QColor fill = band.color;
+        fill.setAlpha(40);
+
+        QCPGraph* gLo = plot->addGraph();
+        gLo->setData(t, lo);
+        gLo->setPen(QPen(fill, 1));
+        gLo->removeFromLegend();
+        QCPGraph* gHi = plot->addGraph();
+        gHi->setData(t, hi);
+        gHi->setPen(QPen(fill, 1));
+        gHi->setBrush(QBrush(fill));
+        gHi->setChannelFillGraph(gLo);
+        gHi->setName(band.name + " 范围");
+        QCPGraph* gMean = plot->addGraph();
+        gMean->setData(t, mean);
+        gMean->setPen(QPen(band.color, 2));
+        gMean->setName(band.name + " 平均");
+    }
+    plot->rescaleAxes();
+    if (plot->xAxis->range().lower <= 0) plot->xAxis->setRangeLower(1e-3);
+    if (plot->yAxis->range().lower <= 0) plot->yAxis->setRangeLower(1e-3);
+    plot->replot();
+}
+
+bool ModelSweepDialog::loadResult(const QString& path)
+{
+    m_caseValues.clear();
+    if (!m_file.open(localPath(path))) return false;
+
+    // 只把各工况的参数值读入内存 (曲线族查找用)，曲线数据按需读取
+    const int a = (int)m_file.axisIds().size();
+    m_caseValues.reserve((int)(m_file.caseCount() * a));
+    std::vector<double> values;
+    for (long long i = 0; i < m_file.caseCount(); ++i) {
+        m_file.readCase(i, &values);
+        for (double v : values) m_caseValues.append(v);
+    }
+
+    QSignalBlocker b1(ui->comboFamilyAxis);
+    QSignalBlocker b2(ui->spinReference);
+    ui->comboFamilyAxis->clear();
+    ui->comboFamilyAxis->addItem("按工况序号");
+    for (int id : m_file.axisIds()) ui->comboFamilyAxis->addItem(ModelParams::name((ModelParams::Id)id));
+    ui->comboFamilyAxis->setCurrentIndex(a > 0 ? 1 : 0);
+    ui->spinReference->setRange(0, (int)std::max(0LL, m_file.caseCount() - 1));
+    ui->spinReference->setValue(0);
+    updateFamilyPlot();
+    return true;
+}
+
+void ModelSweepDialog::updateFamilyPlot()
+{
+    MouseZoom* plot = ui->chartFamily->getPlot();
+    plot->clearGraphs();
+    const long long n = m_file.isOpen() ? m_file.caseCount() : 0;
+    if (n == 0) {
+        ui->labelFamilyInfo->clear();
+        plot->replot();
+        return;
+    }
+
+    const int a = (int)m_file.axisIds().size();
+    const long long ref = std::min<long long>(ui->spinReference->value(), n - 1);
+    const int page = ui->spinPageSize->value();
+    const int axis = ui->comboFamilyAxis->currentIndex() - 1;
+    auto value = [&](long long i, int j) { return m_caseValues[(int)(i * a + j)]; };
+
+    QVector<long long> picked;
+    QString info;
+    if (axis < 0) {
+        for (long long i = ref; i < std::min(n, ref + page); ++i) picked.append(i);
+        info = QString("工况 %1 ~ %2 / 共 %3").arg(ref).arg(ref + picked.size() - 1).arg(n);
+    } else {
+        // 其他参数与参考工况相同的工况
+        QVector<long long> matches;
+        for (long long i = 0; i < n; ++i) {
+            bool same = true;
+            for (int j = 0; j < a && same; ++j) same = (j == axis) || value(i, j) == value(ref, j);
+            if (same) matches.append(i);
+        }
+        if (matches.size() > 1) {
+            // 超出最多曲线数时等间隔抽取
+            if (matches.size() > page) {
+                for (int k = 0; k < page; ++k) picked.append(matches[(int)((long long)k * (matches.size() - 1) / std::max(page - 1, 1))]);
+            } else {
+                picked = matches;
+            }
+            info = QString("%1 变化，其他参数同工况 %2 (共 %3 条，显示 %4 条)")
+                       .arg(ui->comboFamilyAxis->currentText()).arg(ref).arg(matches.size()).arg(picked.size());
+        } else {
+            // 抽样工况没有完全相同的组合: 取其他参数 (按范围归一化，正值取对数) 最接近的工况
+            QVector<double> lo(a, HUGE_VAL), hi(a, -HUGE_VAL);
+            QVector<bool> logAxis(a, true);
+            for (long long i = 0; i < n; ++i) {
+                for (int j = 0; j < a; ++j) {
+                    lo[j] = std::min(lo[j], value(i, j));
+                    hi[j] = std::max(hi[j], value(i, j));
+                    if (value(i, j) <= 0.0) logAxis[j] = false;
+                }
+            }
+            auto coord = [&](long long i, int j) {
+                double v = value(i, j);
+                double l = lo[j], h = hi[j];
+                if (logAxis[j]) { v = std::log(v); l = std::log(l); h = std::log(h); }
+                return h > l ? (v - l) / (h - l) : 0.0;
+            };
+            QVector<QPair<double, long long>> dist;
+            for (long long i = 0; i < n; ++i) {
+                double s = 0.0;
+                for (int j = 0; j < a; ++j) {
+                    if (j == axis) continue;
+                    double diff = coord(i, j) - coord(ref, j);
+                    s += diff * diff;
+                }
+                dist.append(qMakePair(s, i));
+            }
+            std::sort(dist.begin(), dist.end());
+            for (int k = 0; k < dist.size() && k < page; ++k) picked.append(dist[k].second);
+            info = QString("没有其他参数完全相同的工况，显示与工况 %1 最接近的 %2 条").arg(ref).arg(picked.size());
+        }
+        std::sort(picked.begin(), picked.end(), [&](long long x, long long y) { return value(x, axis) < value(y, axis); });
+    }
+    ui->labelFamilyInfo->setText(info);
+
+    std::vector<double> values, p, d;
+    for (int k = 0; k < picked.size(); ++k) {
+        if (!m_file.readCase(picked[k], &values, &p, &d)) continue;
+        QStringList parts;
+        for (int j = 0; j < a; ++j) {
+            if (axis >= 0 && j != axis) continue;
+            parts << QString("%1=%2").arg(ModelParams::name((ModelParams::Id)m_file.axisIds()[j])).arg(values[j], 0, 'g', 4);
+        }
+        QColor color = QColor::fromHsv((int)(300.0 * k / std::max(1, (int)picked.size() - 1)), 230, 200);
+        const std::vector<double>& t = m_file.time();
+        QCPGraph* gP = plot->addGraph();
+        gP->setData(QVector<double>(t.begin(), t.end()), QVector<double>(p.begin(), p.end()));
+        gP->setPen(QPen(color, 2));
+        gP->setName(parts.join(", "));
+        QCPGraph* gD = plot->addGraph();
+        gD->setData(QVector<double>(t.begin(), t.end()), QVector<double>(d.begin(), d.end()));
+        gD->setPen(QPen(color, 2, Qt::DashLine));
+        gD->removeFromLegend();
+    }
+    plot->rescaleAxes();
+    if (plot->xAxis->range().lower <= 0) plot->xAxis->setRangeLower(1e-3);
+    if (plot->yAxis->range().lower <= 0) plot->yAxis->setRangeLower(1e-3);
+    plot->replot();
+}
+
+void ModelSweepDialog::reject()
+{
+    if (m_isRunning) {
+        m_cancelRequested = true;
+        m_watcher.waitForFinished();
+    }
+    QDialog::reject();
+}
@@ -0,0 +1,85 @@
+/*
+ * 文件名: modelsweepdialog.h
+ * 文件作用: 多参数扫描对话框头文件
+ * 功能描述:
+ * 1. 编辑 2~5 个扫描参数 (范围或取值列表)，选择全组合或拉丁超立方抽样，指定结果文件。
+ * 2. 扫描由 ModelSweep 在后台线程执行，结果直接写入二进制文件，进度条显示进度，可取消。
+ * 3. 汇总图只画压力/导数包络 (最小-最大带与平均曲线)；曲线族页按需从文件读取少量曲线显示，
+ *    图表中不保存全部曲线。
+ */
+
+#ifndef MODELSWEEPDIALOG_H
+#define MODELSWEEPDIALOG_H
+
+#include <QDialog>
+#include <QMap>
+#include <QVector>
+#include <QFutureWatcher>
+#include <atomic>
+#include "modelsolver.h"
+#include "modelsweep.h"
+
+namespace Ui {
+class ModelSweepDialog;
+}
+
+class MouseZoom;
+
+class ModelSweepDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // baseParams: 模型页当前参数；presetValues: 模型页中给出多个取值的参数 (预填为扫描参数)
+    explicit ModelSweepDialog(ModelKernel::ModelType type, const QMap<QString, double>& baseParams,
+                              const QMap<QString, QVector<double>>& presetValues, const QVector<double>& time,
+                              bool highPrecision, QWidget *parent = nullptr);
+    ~ModelSweepDialog();
+
+    // 可扫描的参数名 (与模型页参数名一致)
+    static QStringList sweepableParameters();
+
+signals:
+    // 内部信号: 后台线程每写完一块报告一次进度
+    void sigProgress(qint64 done, qint64 total);
+
+public slots:
+    void reject() override;        // 计算中关闭时先取消并等待后台任务结束
+
+private slots:
+    void onAddAxis();
+    void onRemoveAxis();
+    void onBrowse();
+    void onRunClicked();           // 开始扫描 / 取消
+    void onOpenResult();           // 打开已有结果文件
+    void onProgress(qint64 done, qint64 total);
+    void onSweepFinished();
+    void onPlanChanged();          // 参数表或抽样方式变化: 更新计划工况数
+    void updateFamilyPlot();       // 曲线族页: 按变化参数与参考工况读取曲线
+
+private:
+    void addAxisRow(const QString& name, double minValue, double maxValue, int count, bool logScale,
+                    const QVector<double>& values);
+    bool buildPlan(ModelSweep::Plan& plan, QString* error) const;
+    bool loadResult(const QString& path);           // 读取结果文件的工况参数表，刷新曲线族页
+    void plotEnvelope(const ModelSweep::Envelope& env, const QVector<double>& time);
+    static void setupLogPlot(MouseZoom* plot);
+
+private:
+    Ui::ModelSweepDialog *ui;
+
+    ModelKernel::ModelType m_type;
+    QMap<QString, double> m_baseParams;
+    QVector<double> m_time;
+    bool m_highPrecision;
+
+    QFutureWatcher<ModelSweep::Result> m_watcher;   // 后台扫描任务监视器
+    std::atomic<bool> m_cancelRequested;
+    bool m_isRunning;
+    QString m_runningPath;
+
+    ModelSweepFile m_file;                          // 当前显示的结果文件
+    QVector<double> m_caseValues;                   // 结果文件中各工况的扫描参数值 (按行存放)
+};
+
+#endif // MODELSWEEPDIALOG_H
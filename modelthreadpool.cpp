@@ -0,0 +1,135 @@
+/*
+ * 文件名: modelthreadpool.cpp
+ * 文件作用: 模型计算内核线程池实现
+ * 功能描述:
+ * 1. 工作线程从任务队列中领取并行任务，按原子计数器动态领取下标。
+ * 2. 调用线程与工作线程一起领取下标，全部下标完成后返回。
+ * 3. 未及时启动的工作线程领取不到下标时直接返回，不会阻塞调用方。
+ */
+
+#include "modelthreadpool.h"
+
+#include <atomic>
+#include <algorithm>
+
+namespace {
+// 标记当前线程是否为线程池工作线程 (用于嵌套调用时退化为串行)
+thread_local bool t_isPoolWorker = false;
+}
+
+struct ModelThreadPool::Job
+{
+    const std::function<void(int)>* body = nullptr;
+    int count = 0;
+    std::atomic<int> next{0};
+    std::atomic<int> done{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+ModelThreadPool& ModelThreadPool::instance()
+{
+    static ModelThreadPool pool;
+    return pool;
+}
+
+int ModelThreadPool::idealThreadCount()
+{
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? (int)n : 1;
+}
+
+int ModelThreadPool::resolveThreadCount(int threadCount)
+{
+    if (threadCount <= 0) return idealThreadCount();
+    return threadCount;
+}
+
+ModelThreadPool::ModelThreadPool()
+    : m_stopping(false)
+{
+    // 调用线程本身也参与计算，因此只需创建 (核心数 - 1) 个工作线程
+    int workerCount = idealThreadCount() - 1;
+    for (int i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ModelThreadPool::~ModelThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cond.notify_all();
+    for (std::thread& t : m_workers) {
+        if (t.joinable()) t.join();
+    }
+}
+
+void ModelThreadPool::workerLoop()
+{
+    t_isPoolWorker = true;
+    for (;;) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+            if (m_stopping && m_queue.empty()) return;
+            job = m_queue.front();
+            m_queue.pop_front();
+        }
+        runJob(*job);
+    }
+}
+
+void ModelThreadPool::runJob(Job& job)
+{
+    for (;;) {
+        int i = job.next.fetch_add(1);
+        if (i >= job.count) break;
+        (*job.body)(i);
+        if (job.done.fetch_add(1) + 1 == job.count) {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            job.finished.notify_all();
+        }
+    }
+}
+
+void ModelThreadPool::parallelFor(int count, int maxThreads, const std::function<void(int)>& body)
+{
+    if (count <= 0) return;
+
+    int threads = std::min(resolveThreadCount(maxThreads), count);
+    threads = std::min(threads, (int)m_workers.size() + 1);
+
+    // 单线程或嵌套调用: 直接串行执行
+    if (threads <= 1 || t_isPoolWorker) {
+        for (int i = 0; i < count; ++i) body(i);
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->body = &body;
+    job->count = count;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int i = 0; i < threads - 1; ++i) m_queue.push_back(job);
+    }
+    m_cond.notify_all();
+
+    // 调用线程参与计算
+    runJob(*job);
+
+    {
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->finished.wait(lock, [&job]() { return job->done.load() >= job->count; });
+    }
+
+    // 移除尚未被工作线程领取的队列项
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), job), m_queue.end());
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ * 文件名: modelthreadpool.h
+ * 文件作用: 模型计算内核使用的线程池头文件 (纯 C++ 实现，无 Qt 依赖)
+ * 功能描述:
+ * 1. 维护一组常驻工作线程，避免每次反演都创建/销毁线程。
+ * 2. 提供 parallelFor 接口：将 [0, count) 的独立任务分配给多个线程执行，调用线程同样参与计算。
+ * 3. 每个下标只被执行一次，结果写入调用方预先分配的独立位置，因此输出与线程数无关 (确定性)。
+ * 4. 在工作线程内部再次调用 parallelFor 时自动退化为串行执行，避免嵌套并行导致的死锁。
+ */
+
+#ifndef MODELTHREADPOOL_H
+#define MODELTHREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+
+class ModelThreadPool
+{
+public:
+    // 获取全局线程池 (首次调用时创建)
+    static ModelThreadPool& instance();
+
+    // 机器可用的硬件线程数 (至少为1)
+    static int idealThreadCount();
+
+    // 将 threadCount 规范化: <=0 表示使用全部核心
+    static int resolveThreadCount(int threadCount);
+
+    // 并行执行 body(i), i = 0 .. count-1，阻塞直到全部完成
+    // maxThreads: 参与计算的最大线程数 (含调用线程)，<=0 表示使用全部核心
+    void parallelFor(int count, int maxThreads, const std::function<void(int)>& body);
+
+    ~ModelThreadPool();
+
+private:
+    ModelThreadPool();
+    ModelThreadPool(const ModelThreadPool&) = delete;
+    ModelThreadPool& operator=(const ModelThreadPool&) = delete;
+
+    struct Job;
+    void workerLoop();
+    static void runJob(Job& job);
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::shared_ptr<Job>> m_queue;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    bool m_stopping;
+};
+
+#endif // MODELTHREADPOOL_H
@@ -0,0 +1,274 @@
+/*
+ * 文件名: modeltoeplitz.h
+ * 文件作用: 对称 Toeplitz 线性方程组的 FFT 迭代求解 (纯模板头文件，无 Qt 依赖)
+ * 功能描述:
+ * 1. 任意长度的 FFT: 2 的幂次长度使用基 2 迭代算法，其余长度使用 Bluestein (chirp-z) 转换为 2 的幂次卷积。
+ * 2. 对称 Toeplitz 矩阵 (由第一列给出) 嵌入 2 的幂次循环矩阵，矩阵-向量乘积为 O(n log n)。
+ * 3. 预条件使用 T. Chan 最优循环矩阵，特征值由一次长度 n 的 FFT 得到，求逆同样为 O(n log n)。
+ * 4. 右预条件重启 GMRES 求解，实数与复数矩阵共用复数运算；未收敛时返回 false，由调用方改用直接消元。
+ */
+
+#ifndef MODELTOEPLITZ_H
+#define MODELTOEPLITZ_H
+
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <algorithm>
+
+namespace ModelToeplitz {
+
+typedef std::complex<double> cplx;
+
+inline double realValue(const cplx& v, double*) { return v.real(); }
+inline cplx realValue(const cplx& v, cplx*) { return v; }
+
+// 长度 n (2 的幂次) 的正变换旋转因子 exp(-2πik/n), k < n/2 (逐项直接计算，不做连乘以免累积误差)
+inline std::vector<cplx> twiddles(int n)
+{
+    const double pi = 3.14159265358979323846;
+    std::vector<cplx> w(std::max(n / 2, 1));
+    for (int k = 0; k < n / 2; ++k) w[k] = std::polar(1.0, -2.0 * pi * k / n);
+    return w;
+}
+
+// 原地基 2 FFT (n 为 2 的幂次，w 为 twiddles(n))，inverse 时不做 1/n 归一化
+inline void fftPow2(cplx* a, int n, const cplx* w, bool inverse)
+{
+    for (int i = 1, j = 0; i < n; ++i) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(a[i], a[j]);
+    }
+    for (int len = 2; len <= n; len <<= 1) {
+        int half = len >> 1, stride = n / len;
+        for (int i = 0; i < n; i += len) {
+            for (int k = 0; k < half; ++k) {
+                cplx wk = inverse ? std::conj(w[k * stride]) : w[k * stride];
+                cplx u = a[i + k], v = a[i + k + half] * wk;
+                a[i + k] = u + v;
+                a[i + k + half] = u - v;
+            }
+        }
+    }
+}
+
+inline int nextPow2(int n)
+{
+    int m = 1;
+    while (m < n) m <<= 1;
+    return m;
+}
+
+// 长度 n 的 DFT 计划 (Bluestein 所需的 chirp 及其卷积核的频谱只计算一次)
+class Dft
+{
+public:
+    explicit Dft(int n) : m_n(n), m_pow2((n & (n - 1)) == 0)
+    {
+        if (m_pow2) { m_twiddle = twiddles(n); return; }
+        const double pi = 3.14159265358979323846;
+        m_m = nextPow2(2 * n - 1);
+        m_twiddle = twiddles(m_m);
+        m_chirp.resize(n);
+        for (int k = 0; k < n; ++k) {
+            // k² 对 2n 取模，避免大 k 时相位丢失精度
+            long long k2 = ((long long)k * k) % (2LL * n);
+            m_chirp[k] = std::polar(1.0, -pi * (double)k2 / n);
+        }
+        m_kernel.assign(m_m, cplx(0.0));
+        m_kernel[0] = std::conj(m_chirp[0]);
+        for (int k = 1; k < n; ++k) m_kernel[k] = m_kernel[m_m - k] = std::conj(m_chirp[k]);
+        fftPow2(m_kernel.data(), m_m, m_twiddle.data(), false);
+        m_work.resize(m_m);
+    }
+
+    int size() const { return m_n; }
+
+    // 原地变换，inverse 时包含 1/n 归一化
+    void transform(cplx* a, bool inverse)
+    {
+        if (m_pow2) {
+            fftPow2(a, m_n, m_twiddle.data(), inverse);
+        } else {
+            // 逆变换: conj(DFT(conj(a)))
+            if (inverse) for (int k = 0; k < m_n; ++k) a[k] = std::conj(a[k]);
+            std::fill(m_work.begin(), m_work.end(), cplx(0.0));
+            for (int k = 0; k < m_n; ++k) m_work[k] = a[k] * m_chirp[k];
+            fftPow2(m_work.data(), m_m, m_twiddle.data(), false);
+            for (int k = 0; k < m_m; ++k) m_work[k] *= m_kernel[k];
+            fftPow2(m_work.data(), m_m, m_twiddle.data(), true);
+            double scale = 1.0 / m_m;
+            for (int k = 0; k < m_n; ++k) a[k] = m_work[k] * m_chirp[k] * scale;
+            if (inverse) for (int k = 0; k < m_n; ++k) a[k] = std::conj(a[k]);
+        }
+        if (inverse) {
+            double scale = 1.0 / m_n;
+            for (int k = 0; k < m_n; ++k) a[k] *= scale;
+        }
+    }
+
+private:
+    int m_n;
+    bool m_pow2;
+    int m_m = 0;
+    std::vector<cplx> m_twiddle, m_chirp, m_kernel, m_work;
+};
+
+// 对称 Toeplitz 矩阵 T(i, j) = t[|i - j|]: FFT 矩阵-向量乘积与 T. Chan 循环预条件
+class SymmetricToeplitz
+{
+public:
+    template<class V>
+    SymmetricToeplitz(const V* t, int n) : m_n(n), m_m(nextPow2(2 * n)), m_dft(n), m_twiddle(twiddles(m_m))
+    {
+        // 循环嵌入: [t0 .. t(n-1), 0 .., t(n-1) .. t1]
+        m_embed.assign(m_m, cplx(0.0));
+        m_embed[0] = t[0];
+        for (int k = 1; k < n; ++k) m_embed[k] = m_embed[m_m - k] = t[k];
+        fftPow2(m_embed.data(), m_m, m_twiddle.data(), false);
+
+        // T. Chan 循环矩阵 c_k = ((n-k) t_k + k t_(n-k)) / n 的特征值
+        m_precond.resize(n);
+        m_precond[0] = t[0];
+        for (int k = 1; k < n; ++k) m_precond[k] = ((double)(n - k) * cplx(t[k]) + (double)k * cplx(t[n - k])) / (double)n;
+        m_dft.transform(m_precond.data(), false);
+        m_work.resize(m_m);
+    }
+
+    int size() const { return m_n; }
+
+    // y = T x
+    void multiply(const cplx* x, cplx* y)
+    {
+        std::fill(m_work.begin(), m_work.end(), cplx(0.0));
+        std::copy(x, x + m_n, m_work.begin());
+        fftPow2(m_work.data(), m_m, m_twiddle.data(), false);
+        for (int k = 0; k < m_m; ++k) m_work[k] *= m_embed[k];
+        fftPow2(m_work.data(), m_m, m_twiddle.data(), true);
+        double scale = 1.0 / m_m;
+        for (int k = 0; k < m_n; ++k) y[k] = m_work[k] * scale;
+    }
+
+    // 原地 x = C⁻¹ x (C 为 T. Chan 循环预条件矩阵)
+    void precondition(cplx* x)
+    {
+        m_dft.transform(x, false);
+        for (int k = 0; k < m_n; ++k) {
+            if (m_precond[k] != 0.0) x[k] /= m_precond[k];
+        }
+        m_dft.transform(x, true);
+    }
+
+private:
+    int m_n, m_m;
+    Dft m_dft;
+    std::vector<cplx> m_twiddle, m_embed, m_precond, m_work;
+};
+
+// 右预条件重启 GMRES(restart) 解 A x = b，相对残差 ||b - A x|| / ||b|| <= tol 时返回 true
+// iterations 非空时输出总迭代次数
+inline bool gmres(SymmetricToeplitz& A, const cplx* b, cplx* x, double tol, int restart, int maxIterations,
+                  int* iterations = nullptr)
+{
+    int n = A.size();
+    std::vector<cplx> r(n), w(n), z(n);
+    std::vector<cplx> V((size_t)(restart + 1) * n), H((size_t)(restart + 1) * restart);
+    std::vector<cplx> cs(restart), sn(restart), g(restart + 1);
+    double bNorm = 0.0;
+    for (int i = 0; i < n; ++i) bNorm += std::norm(b[i]);
+    bNorm = std::sqrt(bNorm);
+    std::fill(x, x + n, cplx(0.0));
+    if (iterations) *iterations = 0;
+    if (bNorm == 0.0) return true;
+
+    int total = 0;
+    while (total < maxIterations) {
+        // r = b - A x
+        A.multiply(x, w.data());
+        double beta = 0.0;
+        for (int i = 0; i < n; ++i) { r[i] = b[i] - w[i]; beta += std::norm(r[i]); }
+        beta = std::sqrt(beta);
+        if (beta <= tol * bNorm) { if (iterations) *iterations = total; return true; }
+
+        for (int i = 0; i < n; ++i) V[i] = r[i] / beta;
+        std::fill(g.begin(), g.end(), cplx(0.0));
+        g[0] = beta;
+        int k = 0;
+        bool converged = false;
+        for (; k < restart && total < maxIterations; ++k, ++total) {
+            // w = A M⁻¹ v_k
+            std::copy(&V[(size_t)k * n], &V[(size_t)k * n] + n, z.begin());
+            A.precondition(z.data());
+            A.multiply(z.data(), w.data());
+            // 修正 Gram-Schmidt
+            for (int j = 0; j <= k; ++j) {
+                const cplx* vj = &V[(size_t)j * n];
+                cplx h = 0.0;
+                for (int i = 0; i < n; ++i) h += std::conj(vj[i]) * w[i];
+                H[(size_t)j * restart + k] = h;
+                for (int i = 0; i < n; ++i) w[i] -= h * vj[i];
+            }
+            double hNext = 0.0;
+            for (int i = 0; i < n; ++i) hNext += std::norm(w[i]);
+            hNext = std::sqrt(hNext);
+            H[(size_t)(k + 1) * restart + k] = hNext;
+            if (hNext > 0.0) for (int i = 0; i < n; ++i) V[(size_t)(k + 1) * n + i] = w[i] / hNext;
+
+            // Givens 旋转消去次对角元
+            for (int j = 0; j < k; ++j) {
+                cplx a = H[(size_t)j * restart + k], c = H[(size_t)(j + 1) * restart + k];
+                H[(size_t)j * restart + k] = std::conj(cs[j]) * a + std::conj(sn[j]) * c;
+                H[(size_t)(j + 1) * restart + k] = -sn[j] * a + cs[j] * c;
+            }
+            cplx a = H[(size_t)k * restart + k], c = H[(size_t)(k + 1) * restart + k];
+            double denom = std::sqrt(std::norm(a) + std::norm(c));
+            if (denom == 0.0) { cs[k] = 1.0; sn[k] = 0.0; }
+            else { cs[k] = a / denom; sn[k] = c / denom; }
+            H[(size_t)k * restart + k] = std::conj(cs[k]) * a + std::conj(sn[k]) * c;
+            H[(size_t)(k + 1) * restart + k] = 0.0;
+            g[k + 1] = -sn[k] * g[k];
+            g[k] = std::conj(cs[k]) * g[k];
+            if (std::abs(g[k + 1]) <= tol * bNorm || hNext == 0.0) { ++k; ++total; converged = true; break; }
+        }
+
+        // 回代求 y，x += M⁻¹ V y
+        std::vector<cplx> y(k);
+        for (int i = k - 1; i >= 0; --i) {
+            cplx v = g[i];
+            for (int j = i + 1; j < k; ++j) v -= H[(size_t)i * restart + j] * y[j];
+            y[i] = v / H[(size_t)i * restart + i];
+        }
+        std::fill(z.begin(), z.end(), cplx(0.0));
+        for (int j = 0; j < k; ++j) {
+            for (int i = 0; i < n; ++i) z[i] += y[j] * V[(size_t)j * n + i];
+        }
+        A.precondition(z.data());
+        for (int i = 0; i < n; ++i) x[i] += z[i];
+        if (converged) {
+            // 以真实残差确认 (预条件后的递推残差可能偏乐观)
+            A.multiply(x, w.data());
+            double res = 0.0;
+            for (int i = 0; i < n; ++i) res += std::norm(b[i] - w[i]);
+            if (std::sqrt(res) <= 10.0 * tol * bNorm) { if (iterations) *iterations = total; return true; }
+        }
+    }
+    if (iterations) *iterations = total;
+    return false;
+}
+
+// 解对称 Toeplitz 方程组 T y = 1 (T 的第一列为 t)，收敛时返回 true 并写出 y
+template<class T>
+bool solveUnitRhs(const T* t, int n, T* y, double tol, int* iterations = nullptr)
+{
+    SymmetricToeplitz A(t, n);
+    std::vector<cplx> b(n, cplx(1.0)), x(n);
+    if (!gmres(A, b.data(), x.data(), tol, 40, 400, iterations)) return false;
+    for (int i = 0; i < n; ++i) y[i] = realValue(x[i], (T*)nullptr);
+    return true;
+}
+
+} // namespace ModelToeplitz
+
+#endif // MODELTOEPLITZ_H
@@ -3,19 +3,20 @@
  * 文件作用: 压裂水平井复合页岩油模型计算实现
  * 功能描述:
  * 1. 包含6种不同边界和井储条件组合的页岩油模型。
- * 2. 实现了 Stehfest 数值反演算法。
- * 3. 实现了 PWD_composite 核心数学模型计算。
+ * 2. 组织界面参数，调用 ModelSolver/ModelKernel 完成理论曲线计算。
+ * 3. 支持单参数敏感性分析 (逗号分隔的多个取值)，曲线条数不限。
  * 4. [修改] 使用 ChartWidget 进行绘图展示。
+ * 5. 曲线在后台线程计算 (QtConcurrent + 内核线程池，各曲线并行)，算完一条画一条，
+ *    计算中按钮变为"取消计算"，未开始的曲线不再计算。
+ * 6. "参数扫描"按钮打开多参数扫描对话框 (ModelSweepDialog)，模型页中多值参数预填为扫描参数。
  */
 
 #include "modelwidget01-06.h"
 #include "ui_modelwidget01-06.h"
 #include "modelmanager.h"
-#include "pressurederivativecalculator.h"
 #include "modelparameter.h"
-
-#include <Eigen/Dense>
-#include <boost/math/special_functions/bessel.hpp>
+#include "modelthreadpool.h"
+#include "modelsweepdialog.h"
 
 #include <cmath>
 #include <algorithm>
@@ -24,17 +25,17 @@
 #include <QFileDialog>
 #include <QTextStream>
 #include <QDateTime>
-#include <QCoreApplication>
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+#include <QtConcurrent>
 
 ModelWidget01_06::ModelWidget01_06(ModelType type, QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::ModelWidget01_06)
     , m_type(type)
     , m_highPrecision(true)
+    , m_cancelRequested(false)
+    , m_isCalculating(false)
+    , m_isSensitivity(false)
+    , m_lastCurve(-1)
 {
     ui->setupUi(this);
     m_colorList = { Qt::red, Qt::blue, QColor(0,180,0), Qt::magenta, QColor(255,140,0), Qt::cyan };
@@ -45,7 +46,13 @@ ModelWidget01_06::ModelWidget01_06(ModelType type, QWidget *parent)
     onResetParameters();
 }
 
-ModelWidget01_06::~ModelWidget01_06() { delete ui; }
+ModelWidget01_06::~ModelWidget01_06()
+{
+    // 后台任务引用本对象的信号与取消标志，必须等其结束
+    m_cancelRequested = true;
+    m_watcher.waitForFinished();
+    delete ui;
+}
 
 QString ModelWidget01_06::getModelName() const {
     switch(m_type) {
@@ -124,6 +131,7 @@ void ModelWidget01_06::initChart() {
 void ModelWidget01_06::setupConnections() {
     connect(ui->calculateButton, &QPushButton::clicked, this, &ModelWidget01_06::onCalculateClicked);
     connect(ui->resetButton, &QPushButton::clicked, this, &ModelWidget01_06::onResetParameters);
+    connect(ui->sweepButton, &QPushButton::clicked, this, &ModelWidget01_06::onSweepClicked);
 
     // 连接 ChartWidget 的导出数据信号
     connect(ui->chartWidget, &ChartWidget::exportDataTriggered, this, &ModelWidget01_06::onExportData);
@@ -134,6 +142,10 @@ void ModelWidget01_06::setupConnections() {
     connect(ui->LEdit, &QLineEdit::editingFinished, this, &ModelWidget01_06::onDependentParamsChanged);
     connect(ui->LfEdit, &QLineEdit::editingFinished, this, &ModelWidget01_06::onDependentParamsChanged);
     connect(ui->checkShowPoints, &QCheckBox::toggled, this, &ModelWidget01_06::onShowPointsToggled);
+
+    // 后台计算: 逐条曲线回到界面线程绘制，全部结束后恢复按钮
+    connect(this, &ModelWidget01_06::sigCurveReady, this, &ModelWidget01_06::onCurveReady, Qt::QueuedConnection);
+    connect(&m_watcher, &QFutureWatcher<void>::finished, this, &ModelWidget01_06::onCalculationFinished);
 }
 
 void ModelWidget01_06::setHighPrecision(bool high) { m_highPrecision = high; }
@@ -208,18 +220,17 @@ void ModelWidget01_06::onShowPointsToggled(bool checked) {
 }
 
 void ModelWidget01_06::onCalculateClicked() {
-    ui->calculateButton->setEnabled(false);
-    ui->calculateButton->setText("计算中...");
-    QCoreApplication::processEvents();
+    // 计算中再次点击即取消: 正在计算的曲线算完为止，其余不再开始
+    if (m_isCalculating) {
+        m_cancelRequested = true;
+        ui->calculateButton->setEnabled(false);
+        ui->calculateButton->setText("正在取消...");
+        return;
+    }
     runCalculation();
-    ui->calculateButton->setEnabled(true);
-    ui->calculateButton->setText("开始计算");
 }
 
-void ModelWidget01_06::runCalculation() {
-    MouseZoom* plot = ui->chartWidget->getPlot();
-    plot->clearGraphs();
-
+QMap<QString, QVector<double>> ModelWidget01_06::collectRawParams() {
     QMap<QString, QVector<double>> rawParams;
     rawParams["phi"] = parseInput(ui->phiEdit->text());
     rawParams["h"] = parseInput(ui->hEdit->text());
@@ -250,20 +261,10 @@ void ModelWidget01_06::runCalculation() {
         rawParams["cD"] = {0.0};
         rawParams["S"] = {0.0};
     }
+    return rawParams;
+}
 
-    // 敏感性分析检测
-    QString sensitivityKey = "";
-    QVector<double> sensitivityValues;
-    for(auto it = rawParams.begin(); it != rawParams.end(); ++it) {
-        if(it.key() == "t") continue;
-        if(it.value().size() > 1) {
-            sensitivityKey = it.key();
-            sensitivityValues = it.value();
-            break;
-        }
-    }
-    bool isSensitivity = !sensitivityKey.isEmpty();
-
+QMap<QString, double> ModelWidget01_06::buildBaseParams(const QMap<QString, QVector<double>>& rawParams) const {
     QMap<QString, double> baseParams;
     for(auto it = rawParams.begin(); it != rawParams.end(); ++it) {
         baseParams[it.key()] = it.value().isEmpty() ? 0.0 : it.value().first();
@@ -271,58 +272,169 @@ void ModelWidget01_06::runCalculation() {
     baseParams["N"] = m_highPrecision ? 8.0 : 4.0;
     if(baseParams["L"] > 1e-9) baseParams["LfD"] = baseParams["Lf"] / baseParams["L"];
     else baseParams["LfD"] = 0;
+    return baseParams;
+}
 
+QVector<double> ModelWidget01_06::buildTimeSteps(const QMap<QString, double>& baseParams) {
     int nPoints = ui->pointsEdit->text().toInt();
     if(nPoints < 5) nPoints = 5;
 
     double maxTime = baseParams.value("t", 1000.0);
     if(maxTime < 1e-3) maxTime = 1000.0;
-    QVector<double> t = ModelManager::generateLogTimeSteps(nPoints, -3.0, log10(maxTime));
+    // 对数时间网格 (系统设置选择对齐网格时与 Stehfest 节点对齐，相邻倍程的拉普拉斯值可复用)
+    return ModelManager::generateTimeSteps(nPoints, -3.0, log10(maxTime));
+}
 
-    int iterations = isSensitivity ? sensitivityValues.size() : 1;
-    iterations = qMin(iterations, (int)m_colorList.size());
+void ModelWidget01_06::onSweepClicked() {
+    QMap<QString, QVector<double>> rawParams = collectRawParams();
+    QMap<QString, double> baseParams = buildBaseParams(rawParams);
+    QVector<double> t = buildTimeSteps(baseParams);
+
+    // 非模态: 扫描在后台进行，模型页仍可使用；关闭时对话框自行取消并释放
+    ModelSweepDialog* dlg = new ModelSweepDialog(m_type, baseParams, rawParams, t, m_highPrecision, this);
+    dlg->setAttribute(Qt::WA_DeleteOnClose);
+    dlg->setWindowTitle("多参数扫描 - " + getModelName());
+    dlg->show();
+}
 
-    QString resultTextHeader = QString("计算完成 (%1)\n").arg(getModelName());
-    if(isSensitivity) resultTextHeader += QString("敏感性参数: %1\n").arg(sensitivityKey);
+void ModelWidget01_06::runCalculation() {
+    MouseZoom* plot = ui->chartWidget->getPlot();
+    plot->clearGraphs();
+
+    QMap<QString, QVector<double>> rawParams = collectRawParams();
 
+    // 敏感性分析检测
+    QString sensitivityKey = "";
+    QVector<double> sensitivityValues;
+    for(auto it = rawParams.begin(); it != rawParams.end(); ++it) {
+        if(it.key() == "t") continue;
+        if(it.value().size() > 1) {
+            sensitivityKey = it.key();
+            sensitivityValues = it.value();
+            break;
+        }
+    }
+    bool isSensitivity = !sensitivityKey.isEmpty();
+
+    QMap<QString, double> baseParams = buildBaseParams(rawParams);
+    QVector<double> t = buildTimeSteps(baseParams);
+
+    int iterations = isSensitivity ? sensitivityValues.size() : 1;
+
+    // 各曲线的参数在界面线程一次准备好，后台只读
+    QVector<QMap<QString, double>> curveParams;
     for(int i = 0; i < iterations; ++i) {
         QMap<QString, double> currentParams = baseParams;
-        double val = 0;
         if (isSensitivity) {
-            val = sensitivityValues[i];
-            currentParams[sensitivityKey] = val;
+            currentParams[sensitivityKey] = sensitivityValues[i];
             if (sensitivityKey == "L" || sensitivityKey == "Lf") {
                 if(currentParams["L"] > 1e-9) currentParams["LfD"] = currentParams["Lf"] / currentParams["L"];
             }
         }
+        curveParams.append(currentParams);
 
-        ModelCurveData res = calculateTheoreticalCurve(currentParams, t);
-        res_tD = std::get<0>(res);
-        res_pD = std::get<1>(res);
-        res_dpD = std::get<2>(res);
-
-        QColor curveColor = isSensitivity ? m_colorList[i] : Qt::red;
+        // 先按顺序建好空曲线，图例顺序与输入一致，算完后再填数据
         QString legendName;
-        if (isSensitivity) legendName = QString("%1 = %2").arg(sensitivityKey).arg(val);
+        if (isSensitivity) legendName = QString("%1 = %2").arg(sensitivityKey).arg(sensitivityValues[i]);
         else legendName = "理论曲线";
+        plotCurve(ModelCurveData(), legendName, isSensitivity ? curveColor(i) : QColor(Qt::red), isSensitivity);
+    }
+    plot->replot();
 
-        plotCurve(res, legendName, curveColor, isSensitivity);
+    m_isSensitivity = isSensitivity;
+    m_sensitivityKey = sensitivityKey;
+    m_sensitivityValues = sensitivityValues;
+    m_baseParams = baseParams;
+    m_curveDone = QVector<bool>(iterations, false);
+    m_lastCurve = -1;
+    m_cancelRequested = false;
+    m_isCalculating = true;
+    ui->calculateButton->setText("取消计算");
+
+    // 各曲线分配到内核线程池并行计算 (工作线程内的反演自动串行，不会过度订阅)；
+    // 曲线比核心少时，发起线程上的曲线仍按设置的线程数并行反演
+    const ModelType type = m_type;
+    const bool highPrecision = m_highPrecision;
+    m_watcher.setFuture(QtConcurrent::run([this, type, highPrecision, curveParams, t]() {
+        ModelThreadPool::instance().parallelFor(curveParams.size(), ModelSolver::inversionThreadCount(), [&](int i) {
+            if (m_cancelRequested.load()) return;
+            ModelCurveData res = ModelSolver::calculateTheoreticalCurve(type, curveParams[i], t, highPrecision);
+            emit sigCurveReady(i, std::get<0>(res), std::get<1>(res), std::get<2>(res));
+        });
+    }));
+}
+
+void ModelWidget01_06::onCurveReady(int index, QVector<double> t, QVector<double> p, QVector<double> d) {
+    if (!m_isCalculating || index < 0 || index >= m_curveDone.size()) return;
+    MouseZoom* plot = ui->chartWidget->getPlot();
+    if (2 * index + 1 >= plot->graphCount()) return;
+
+    plot->graph(2 * index)->setData(t, p);
+    plot->graph(2 * index + 1)->setData(t, d);
+    m_curveDone[index] = true;
+
+    // 结果文本与导出使用下标最大的已算完曲线 (与顺序计算时最后一条一致)
+    if (index > m_lastCurve) {
+        m_lastCurve = index;
+        res_tD = t;
+        res_pD = p;
+        res_dpD = d;
     }
+    rescalePlot();
+}
 
-    QString resultText = resultTextHeader;
+void ModelWidget01_06::onCalculationFinished() {
+    MouseZoom* plot = ui->chartWidget->getPlot();
+    bool cancelled = m_cancelRequested.load();
+
+    // 取消时删除未算的空曲线 (从后往前删，下标不变)
+    for (int i = m_curveDone.size() - 1; i >= 0; --i) {
+        if (m_curveDone[i] || 2 * i + 1 >= plot->graphCount()) continue;
+        plot->removeGraph(2 * i + 1);
+        plot->removeGraph(2 * i);
+    }
+    m_isCalculating = false;
+    m_cancelRequested = false;
+    ui->calculateButton->setEnabled(true);
+    ui->calculateButton->setText("开始计算");
+
+    if (m_lastCurve < 0) {
+        plot->replot();
+        ui->resultTextEdit->setText("计算已取消");
+        return;
+    }
+
+    int doneCount = m_curveDone.count(true);
+    QString resultText = QString("%1 (%2)\n").arg(cancelled ? "计算已取消" : "计算完成").arg(getModelName());
+    if(m_isSensitivity) {
+        resultText += QString("敏感性参数: %1 (已完成 %2/%3 条)\n").arg(m_sensitivityKey).arg(doneCount).arg(m_curveDone.size());
+        resultText += QString("下表为 %1 = %2\n").arg(m_sensitivityKey).arg(m_sensitivityValues[m_lastCurve]);
+    }
     resultText += "t(h)\t\tDp(MPa)\t\tdDp(MPa)\n";
     for(int i=0; i<res_pD.size(); ++i) {
         resultText += QString("%1\t%2\t%3\n").arg(res_tD[i],0,'e',4).arg(res_pD[i],0,'e',4).arg(res_dpD[i],0,'e',4);
     }
     ui->resultTextEdit->setText(resultText);
 
-    ui->chartWidget->getPlot()->rescaleAxes();
+    rescalePlot();
+    onShowPointsToggled(ui->checkShowPoints->isChecked());
+    if (!cancelled) emit calculationCompleted(getModelName(), m_baseParams);
+}
+
+void ModelWidget01_06::rescalePlot() {
+    MouseZoom* plot = ui->chartWidget->getPlot();
+    plot->rescaleAxes();
     if(plot->xAxis->range().lower <= 0) plot->xAxis->setRangeLower(1e-3);
     if(plot->yAxis->range().lower <= 0) plot->yAxis->setRangeLower(1e-3);
     plot->replot();
+}
 
-    onShowPointsToggled(ui->checkShowPoints->isChecked());
-    emit calculationCompleted(getModelName(), baseParams);
+QColor ModelWidget01_06::curveColor(int index) const {
+    if (index < m_colorList.size()) return m_colorList[index];
+    // 颜色列表用完后按黄金角旋转色相，相邻曲线颜色区分明显
+    int hue = (int)std::fmod(index * 137.508, 360.0);
+    int value = (index / m_colorList.size()) % 2 ? 170 : 220;
+    return QColor::fromHsv(hue, 220, value);
 }
 
 void ModelWidget01_06::plotCurve(const ModelCurveData& data, const QString& name, QColor color, bool isSensitivity) {
@@ -370,226 +482,8 @@ void ModelWidget01_06::onExportData() {
     }
 }
 
-// --- 数学逻辑保持不变 ---
-
+// [修改] 数学计算已迁移至 ModelKernel，本界面只负责组织参数和展示结果
 ModelCurveData ModelWidget01_06::calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime)
 {
-    QVector<double> tPoints = providedTime;
-    if (tPoints.isEmpty()) {
-        tPoints = ModelManager::generateLogTimeSteps(100, -3.0, 3.0);
-    }
-
-    double phi = params.value("phi", 0.05);
-    double mu = params.value("mu", 0.5);
-    double B = params.value("B", 1.05);
-    double Ct = params.value("Ct", 5e-4);
-    double q = params.value("q", 5.0);
-    double h = params.value("h", 20.0);
-    double kf = params.value("kf", 1e-3);
-    double L = params.value("L", 1000.0);
-
-    QVector<double> tD_vec;
-    tD_vec.reserve(tPoints.size());
-    for(double t : tPoints) {
-        double val = 14.4 * kf * t / (phi * mu * Ct * pow(L, 2));
-        tD_vec.append(val);
-    }
-
-    QVector<double> PD_vec, Deriv_vec;
-    auto func = std::bind(&ModelWidget01_06::flaplace_composite, this, std::placeholders::_1, std::placeholders::_2);
-    calculatePDandDeriv(tD_vec, params, func, PD_vec, Deriv_vec);
-
-    double factor = 1.842e-3 * q * mu * B / (kf * h);
-    QVector<double> finalP(tPoints.size()), finalDP(tPoints.size());
-
-    for(int i=0; i<tPoints.size(); ++i) {
-        finalP[i] = factor * PD_vec[i];
-        finalDP[i] = factor * Deriv_vec[i];
-    }
-
-    return std::make_tuple(tPoints, finalP, finalDP);
-}
-
-void ModelWidget01_06::calculatePDandDeriv(const QVector<double>& tD, const QMap<QString, double>& params,
-                                           std::function<double(double, const QMap<QString, double>&)> laplaceFunc,
-                                           QVector<double>& outPD, QVector<double>& outDeriv)
-{
-    int numPoints = tD.size();
-    outPD.resize(numPoints);
-    outDeriv.resize(numPoints);
-
-    int N_param = (int)params.value("N", 4);
-    int N = m_highPrecision ? N_param : 4;
-    if (N % 2 != 0) N = 4;
-    double ln2 = log(2.0);
-
-    double gamaD = params.value("gamaD", 0.0);
-
-    for (int k = 0; k < numPoints; ++k) {
-        double t = tD[k];
-        if (t <= 1e-12) { outPD[k] = 0; continue; }
-        double pd_val = 0.0;
-        for (int m = 1; m <= N; ++m) {
-            double z = m * ln2 / t;
-            double pf = laplaceFunc(z, params);
-            if (std::isnan(pf) || std::isinf(pf)) pf = 0.0;
-            pd_val += stefestCoefficient(m, N) * pf;
-        }
-        outPD[k] = pd_val * ln2 / t;
-
-        if (std::abs(gamaD) > 1e-9) {
-            double arg = 1.0 - gamaD * outPD[k];
-            if (arg > 1e-12) {
-                outPD[k] = -1.0 / gamaD * std::log(arg);
-            }
-        }
-    }
-    if (numPoints > 2) outDeriv = PressureDerivativeCalculator::calculateBourdetDerivative(tD, outPD, 0.1);
-    else outDeriv.fill(0.0);
-}
-
-double ModelWidget01_06::flaplace_composite(double z, const QMap<QString, double>& p) {
-    double kf = p.value("kf");
-    double km = p.value("km");
-    double LfD = p.value("LfD");
-    double rmD = p.value("rmD");
-    double reD = p.value("reD", 0.0);
-    double omga1 = p.value("omega1");
-    double omga2 = p.value("omega2");
-    double remda1 = p.value("lambda1");
-    int nf = (int)p.value("nf", 4); if(nf < 1) nf = 1;
-    double M12 = kf / km;
-    QVector<double> xwD;
-    if (nf == 1) { xwD.append(0.0); } else {
-        double start = -0.9; double end = 0.9; double step = (end - start) / (nf - 1);
-        for(int i=0; i<nf; ++i) xwD.append(start + i * step);
-    }
-    double temp = omga2;
-    double fs1 = omga1 + remda1 * temp / (remda1 + z * temp);
-    double fs2 = M12 * temp;
-
-    double pf = PWD_composite(z, fs1, fs2, M12, LfD, rmD, reD, nf, xwD, m_type);
-
-    bool hasStorage = (m_type == Model_1 || m_type == Model_3 || m_type == Model_5);
-    if (hasStorage) {
-        double CD = p.value("cD", 0.0);
-        double S = p.value("S", 0.0);
-        if (CD > 1e-12 || std::abs(S) > 1e-12) {
-            pf = (z * pf + S) / (z + CD * z * z * (z * pf + S));
-        }
-    }
-
-    return pf;
-}
-
-double ModelWidget01_06::PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD, ModelType type) {
-    using namespace boost::math;
-    QVector<double> ywD(nf, 0.0);
-    double gama1 = sqrt(z * fs1);
-    double gama2 = sqrt(z * fs2);
-    double arg_g2_rm = gama2 * rmD;
-    double arg_g1_rm = gama1 * rmD;
-
-    double k0_g2 = cyl_bessel_k(0, arg_g2_rm);
-    double k1_g2 = cyl_bessel_k(1, arg_g2_rm);
-    double k0_g1 = cyl_bessel_k(0, arg_g1_rm);
-    double k1_g1 = cyl_bessel_k(1, arg_g1_rm);
-
-    double term_mAB_i0 = 0.0;
-    double term_mAB_i1 = 0.0;
-
-    bool isInfinite = (type == Model_1 || type == Model_2);
-    bool isClosed = (type == Model_3 || type == Model_4);
-    bool isConstP = (type == Model_5 || type == Model_6);
-
-    if (!isInfinite) {
-        double arg_re = gama2 * reD;
-        double i1_re_s = scaled_besseli(1, arg_re);
-        double i0_re_s = scaled_besseli(0, arg_re);
-        double k1_re = cyl_bessel_k(1, arg_re);
-        double k0_re = cyl_bessel_k(0, arg_re);
-        double i0_g2_s = scaled_besseli(0, arg_g2_rm);
-        double i1_g2_s = scaled_besseli(1, arg_g2_rm);
-
-        if (isClosed) {
-            if (i1_re_s > 1e-100) {
-                term_mAB_i0 = (k1_re / i1_re_s) * i0_g2_s * std::exp(arg_g2_rm - arg_re);
-                term_mAB_i1 = (k1_re / i1_re_s) * i1_g2_s * std::exp(arg_g2_rm - arg_re);
-            }
-        } else if (isConstP) {
-            if (i0_re_s > 1e-100) {
-                term_mAB_i0 = -(k0_re / i0_re_s) * i0_g2_s * std::exp(arg_g2_rm - arg_re);
-                term_mAB_i1 = -(k0_re / i0_re_s) * i1_g2_s * std::exp(arg_g2_rm - arg_re);
-            }
-        }
-    }
-
-    double term1 = term_mAB_i0 + k0_g2;
-    double term2 = term_mAB_i1 - k1_g2;
-
-    double Acup = M12 * gama1 * k1_g1 * term1 + gama2 * k0_g1 * term2;
-
-    double i1_g1_s = scaled_besseli(1, arg_g1_rm);
-    double i0_g1_s = scaled_besseli(0, arg_g1_rm);
-
-    double Acdown_scaled = M12 * gama1 * i1_g1_s * term1 - gama2 * i0_g1_s * term2;
-
-    if (std::abs(Acdown_scaled) < 1e-100) Acdown_scaled = 1e-100;
-
-    double Ac_prefactor = Acup / Acdown_scaled;
-
-    int size = nf + 1;
-    Eigen::MatrixXd A_mat(size, size);
-    Eigen::VectorXd b_vec(size);
-    b_vec.setZero(); b_vec(nf) = 1.0;
-
-    for (int i = 0; i < nf; ++i) {
-        for (int j = 0; j < nf; ++j) {
-            auto integrand = [&](double a) -> double {
-                double dist = std::sqrt(std::pow(xwD[i] - xwD[j] - a, 2) + std::pow(ywD[i] - ywD[j], 2));
-                double arg_dist = gama1 * dist; if (arg_dist < 1e-10) arg_dist = 1e-10;
-
-                double term2 = 0.0;
-                double exponent = arg_dist - arg_g1_rm;
-                if (exponent > -700.0) {
-                    term2 = Ac_prefactor * scaled_besseli(0, arg_dist) * std::exp(exponent);
-                }
-                return cyl_bessel_k(0, arg_dist) + term2;
-            };
-            double val = adaptiveGauss(integrand, -LfD, LfD, 1e-5, 0, 10);
-            A_mat(i, j) = z * val / (M12 * z * 2 * LfD);
-        }
-    }
-    for (int i = 0; i < nf; ++i) { A_mat(i, nf) = -1.0; A_mat(nf, i) = z; }
-    A_mat(nf, nf) = 0.0;
-
-    return A_mat.fullPivLu().solve(b_vec)(nf);
-}
-
-double ModelWidget01_06::scaled_besseli(int v, double x) {
-    if (x < 0) x = -x;
-    if (x > 600.0) return 1.0 / std::sqrt(2.0 * M_PI * x);
-    return boost::math::cyl_bessel_i(v, x) * std::exp(-x);
-}
-double ModelWidget01_06::gauss15(std::function<double(double)> f, double a, double b) {
-    static const double X[] = { 0.0, 0.201194, 0.394151, 0.570972, 0.724418, 0.848207, 0.937299, 0.987993 };
-    static const double W[] = { 0.202578, 0.198431, 0.186161, 0.166269, 0.139571, 0.107159, 0.070366, 0.030753 };
-    double h = 0.5 * (b - a); double c = 0.5 * (a + b); double s = W[0] * f(c);
-    for (int i = 1; i < 8; ++i) { double dx = h * X[i]; s += W[i] * (f(c - dx) + f(c + dx)); }
-    return s * h;
-}
-double ModelWidget01_06::adaptiveGauss(std::function<double(double)> f, double a, double b, double eps, int depth, int maxDepth) {
-    double c = (a + b) / 2.0; double v1 = gauss15(f, a, b); double v2 = gauss15(f, a, c) + gauss15(f, c, b);
-    if (depth >= maxDepth || std::abs(v1 - v2) < 1e-10 * std::abs(v2) + eps) return v2;
-    return adaptiveGauss(f, a, c, eps/2, depth+1, maxDepth) + adaptiveGauss(f, c, b, eps/2, depth+1, maxDepth);
-}
-double ModelWidget01_06::stefestCoefficient(int i, int N) {
-    double s = 0.0; int k1 = (i + 1) / 2; int k2 = std::min(i, N / 2);
-    for (int k = k1; k <= k2; ++k) {
-        double num = pow(k, N / 2.0) * factorial(2 * k);
-        double den = factorial(N / 2 - k) * factorial(k) * factorial(k - 1) * factorial(i - k) * factorial(2 * k - i);
-        if(den!=0) s += num/den;
-    }
-    return ((i + N / 2) % 2 == 0 ? 1.0 : -1.0) * s;
+    return ModelSolver::calculateTheoreticalCurve(m_type, params, providedTime, m_highPrecision);
 }
-double ModelWidget01_06::factorial(int n) { if(n<=1)return 1; double r=1; for(int i=2;i<=n;++i)r*=i; return r; }
@@ -5,6 +5,8 @@
  * 1. 声明不同类型模型的计算参数和逻辑。
  * 2. 管理界面交互，连接左侧参数设置与右侧图表展示。
  * 3. 引用通用的 ChartWidget 组件替代原有的绘图控件。
+ * 4. 理论曲线/敏感性分析在后台线程计算，各曲线并行，算完一条画一条，计算中可取消。
+ * 5. 多参数扫描 (全组合/拉丁超立方) 由 ModelSweepDialog 完成，以当前参数为基础。
  */
 
 #ifndef MODELWIDGET01_06_H
@@ -14,30 +16,28 @@
 #include <QMap>
 #include <QVector>
 #include <QColor>
-#include <tuple>
-#include <functional>
+#include <QFutureWatcher>
+#include <atomic>
 #include "chartwidget.h" // [新增] 引入通用图表组件
+#include "modelsolver.h" // 无界面的理论曲线计算服务
 
 namespace Ui {
 class ModelWidget01_06;
 }
 
-// 类型定义: <时间, 压力, 导数>
-using ModelCurveData = std::tuple<QVector<double>, QVector<double>, QVector<double>>;
-
 class ModelWidget01_06 : public QWidget
 {
     Q_OBJECT
 
 public:
-    enum ModelType {
-        Model_1 = 0, // 无限大 + 变井储
-        Model_2,     // 无限大 + 恒定井储
-        Model_3,     // 封闭边界 + 变井储
-        Model_4,     // 封闭边界 + 恒定井储
-        Model_5,     // 定压边界 + 变井储
-        Model_6      // 定压边界 + 恒定井储
-    };
+    // 使用计算内核 ModelKernel 中定义的枚举
+    using ModelType = ModelKernel::ModelType;
+    static const ModelType Model_1 = ModelKernel::Model_1; // 无限大 + 变井储
+    static const ModelType Model_2 = ModelKernel::Model_2; // 无限大 + 恒定井储
+    static const ModelType Model_3 = ModelKernel::Model_3; // 封闭边界 + 变井储
+    static const ModelType Model_4 = ModelKernel::Model_4; // 封闭边界 + 恒定井储
+    static const ModelType Model_5 = ModelKernel::Model_5; // 定压边界 + 变井储
+    static const ModelType Model_6 = ModelKernel::Model_6; // 定压边界 + 恒定井储
 
     explicit ModelWidget01_06(ModelType type, QWidget *parent = nullptr);
     ~ModelWidget01_06();
@@ -45,7 +45,7 @@ public:
     // 设置高精度模式 (Stehfest N=8)
     void setHighPrecision(bool high);
 
-    // 计算理论曲线接口
+    // 计算理论曲线接口 (使用本界面的精度设置，实际计算由 ModelSolver 完成)
     ModelCurveData calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
 
     // 获取当前模型名称
@@ -54,9 +54,12 @@ public:
 signals:
     // 信号：计算完成，携带模型名称和参数
     void calculationCompleted(const QString& modelType, const QMap<QString, double>& params);
+    // 内部信号: 后台线程算完第 index 条曲线 (QueuedConnection 送回界面线程)
+    void sigCurveReady(int index, QVector<double> t, QVector<double> p, QVector<double> d);
 
 public slots:
     void onCalculateClicked();     // 点击计算
+    void onSweepClicked();         // 打开多参数扫描对话框
     void onResetParameters();      // 重置参数
     void onDependentParamsChanged(); // 关联参数变更处理
     void onShowPointsToggled(bool checked); // 显示/隐藏数据点
@@ -64,30 +67,28 @@ public slots:
     // [修改] 保留数据导出槽函数，用于响应 ChartWidget 的信号
     void onExportData();
 
+private slots:
+    void onCurveReady(int index, QVector<double> t, QVector<double> p, QVector<double> d); // 绘制一条算完的曲线
+    void onCalculationFinished();  // 后台计算结束 (完成或取消)
+
 private:
     void initUi();
     void initChart();      // 初始化引用 ChartWidget 的逻辑
     void setupConnections();
     void runCalculation();
+    // 界面参数 (每个参数可有多个取值)、由其得到的基础参数与时间网格
+    QMap<QString, QVector<double>> collectRawParams();
+    QMap<QString, double> buildBaseParams(const QMap<QString, QVector<double>>& rawParams) const;
+    QVector<double> buildTimeSteps(const QMap<QString, double>& baseParams);
 
     // 辅助函数
     QVector<double> parseInput(const QString& text);
     void setInputText(QLineEdit* edit, double value);
     void plotCurve(const ModelCurveData& data, const QString& name, QColor color, bool isSensitivity);
+    QColor curveColor(int index) const; // 第 index 条敏感性曲线的颜色 (超出颜色列表时按色相生成)
+    void rescalePlot();                 // 按已有曲线调整坐标范围并重绘
 
-    // --- 数学计算核心 (保持不变) ---
-    void calculatePDandDeriv(const QVector<double>& tD, const QMap<QString, double>& params,
-                             std::function<double(double, const QMap<QString, double>&)> laplaceFunc,
-                             QVector<double>& outPD, QVector<double>& outDeriv);
-
-    double flaplace_composite(double z, const QMap<QString, double>& p);
-    double PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD, ModelType type);
-
-    double scaled_besseli(int v, double x);
-    double gauss15(std::function<double(double)> f, double a, double b);
-    double adaptiveGauss(std::function<double(double)> f, double a, double b, double eps, int depth, int maxDepth);
-    double stefestCoefficient(int i, int N);
-    double factorial(int n);
+    // [修改] 数学计算核心已迁移至无界面的 ModelKernel (modelkernel.h)
 
 private:
     Ui::ModelWidget01_06 *ui;
@@ -99,6 +100,17 @@ private:
     bool m_highPrecision;
     QList<QColor> m_colorList; // 曲线颜色列表
 
+    // 后台计算状态 (只在界面线程读写，m_cancelRequested 由后台线程读取)
+    QFutureWatcher<void> m_watcher;         // 后台计算任务监视器
+    std::atomic<bool> m_cancelRequested;    // 是否收到了取消请求 (未开始的曲线不再计算)
+    bool m_isCalculating;                   // 是否正在计算
+    bool m_isSensitivity;                   // 本次计算是否为敏感性分析
+    QString m_sensitivityKey;               // 敏感性参数名
+    QVector<double> m_sensitivityValues;    // 敏感性参数取值 (每个取值一条曲线)
+    QMap<QString, double> m_baseParams;     // 本次计算的基础参数
+    QVector<bool> m_curveDone;              // 各曲线是否已算完
+    int m_lastCurve;                        // 已算完的下标最大的曲线 (结果文本与导出使用)
+
     // 缓存计算结果
     QVector<double> res_tD;
     QVector<double> res_pD;
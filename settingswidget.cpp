@@ -74,6 +74,10 @@ void SettingsWidget::initInterface()
     // 4. 初始化日志级别
     ui->cmbLogLevel->clear();
     ui->cmbLogLevel->addItems({"仅错误 (Error)", "警告与错误 (Warning)", "一般信息 (Info)", "详细调试 (Debug)"});
+
+    // 5. 初始化拉普拉斯反演算法 (顺序与 ModelInversion::Method 一致)
+    ui->cmbInvMethod->clear();
+    ui->cmbInvMethod->addItems({"Stehfest (默认)", "Talbot (复围道)", "de Hoog (商差分)", "Euler (级数加速)"});
 }
 
 void SettingsWidget::loadSettings()
@@ -105,6 +109,11 @@ void SettingsWidget::loadSettings()
     ui->chkCleanupLogs->setChecked(m_settings->value("system/cleanupLogs", true).toBool());
     ui->spinLogDays->setValue(m_settings->value("system/logRetention", 30).toInt());
     ui->cmbLogLevel->setCurrentIndex(m_settings->value("system/logLevel", 2).toInt());
+    ui->spinCalcThreads->setValue(m_settings->value("system/calcThreads", 0).toInt());
+    ui->cmbInvMethod->setCurrentIndex(m_settings->value("system/invMethod", 0).toInt());
+    ui->spinCalcCache->setValue(m_settings->value("system/calcCacheMB", 64).toInt());
+    ui->spinFitThreads->setValue(m_settings->value("system/fitThreads", 0).toInt());
+    ui->chkAlignedTimeGrid->setChecked(m_settings->value("system/alignedTimeGrid", false).toBool());
 
     m_isModified = false;
 }
@@ -138,6 +147,11 @@ void SettingsWidget::applySettings()
     m_settings->setValue("system/cleanupLogs", ui->chkCleanupLogs->isChecked());
     m_settings->setValue("system/logRetention", ui->spinLogDays->value());
     m_settings->setValue("system/logLevel", ui->cmbLogLevel->currentIndex());
+    m_settings->setValue("system/calcThreads", ui->spinCalcThreads->value());
+    m_settings->setValue("system/invMethod", ui->cmbInvMethod->currentIndex());
+    m_settings->setValue("system/calcCacheMB", ui->spinCalcCache->value());
+    m_settings->setValue("system/fitThreads", ui->spinFitThreads->value());
+    m_settings->setValue("system/alignedTimeGrid", ui->chkAlignedTimeGrid->isChecked());
 
     m_settings->sync(); // 强制写入磁盘
 
@@ -245,3 +259,8 @@ int SettingsWidget::getRateUnitIndex() const { return ui->cmbRateUnit->currentIn
 int SettingsWidget::getPrecision() const { return ui->spinPrecision->value(); }
 int SettingsWidget::getPlotBackgroundStyle() const { return ui->cmbPlotBackground->currentIndex(); }
 bool SettingsWidget::isGridVisibleDefault() const { return ui->chkShowGrid->isChecked(); }
+int SettingsWidget::getCalcThreadCount() const { return ui->spinCalcThreads->value(); }
+int SettingsWidget::getInversionMethod() const { return ui->cmbInvMethod->currentIndex(); }
+int SettingsWidget::getCalcCacheLimit() const { return ui->spinCalcCache->value(); }
+int SettingsWidget::getFitThreadCount() const { return ui->spinFitThreads->value(); }
+bool SettingsWidget::isAlignedTimeGrid() const { return ui->chkAlignedTimeGrid->isChecked(); }
@@ -51,6 +51,13 @@ public:
     int getPlotBackgroundStyle() const; // 0: 白色, 1: 深色
     bool isGridVisibleDefault() const;
 
+    // 模型计算配置
+    int getCalcThreadCount() const;     // 反演线程数, 0: 自动
+    int getInversionMethod() const;     // 反演算法, 0: Stehfest, 1: Talbot, 2: de Hoog, 3: Euler
+    int getCalcCacheLimit() const;      // 计算缓存上限 (MB), 0: 关闭
+    int getFitThreadCount() const;      // 拟合并行计算数, 0: 自动 (核心数减一)
+    bool isAlignedTimeGrid() const;     // 默认时间网格与 Stehfest 节点对齐
+
 signals:
     // 配置变更信号
     void settingsChanged();           // 通用变更信号
@@ -7,6 +7,14 @@
  * 3. 核心算法实现：完整实现了 Levenberg-Marquardt (LM) 非线性最小二乘拟合算法。
  * 4. 提供丰富的交互功能：手动调整参数、权重滑块、模型选择、图表视图控制。
  * 5. 提供结果输出功能：导出拟合参数、导出图表图片、生成 HTML 分析报告。
+ * 6. 雅可比矩阵的正/负扰动残差互相独立，经内核线程池并行计算 (模型计算路径可重入)；
+ *    并行数上限默认为核心数减一，避免拟合期间界面失去响应。
+ * 7. LM 迭代由 ModelFitter 执行，本类负责参数与内部坐标 (对数/线性) 的换算、残差计算和界面通知；
+ *    可选 Broyden 秩一更新、前向差分、Nielsen 阻尼与测地加速，结束时报告停止原因与模型计算次数。
+ * 8. 每次迭代的诊断信息 (阻尼因子、梯度、步长、下降比、计算次数) 实时显示在误差标签下方。
+ * 9. 多起点拟合: 各起点在线程池中并行迭代、逐轮淘汰，最好的候选解显示在图上，全部候选解按误差列表供选用。
+ * 10. 差分进化 + LM: 每代个体并行计算低精度残差 (Stehfest N=4、放宽的网格插值误差)，最好个体改进时
+ *     刷新图上曲线，进化结束 (或停止) 后从最好个体开始 LM 精修。
  */
 
 #include "wt_fittingwidget.h"
@@ -16,11 +24,14 @@
 #include "fittingdatadialog.h"
 #include "pressurederivativecalculator.h"
 #include "pressurederivativecalculator1.h"
+#include "modelthreadpool.h"
+#include "modelfitter.h"
 
 #include <QtConcurrent>
 #include <QMessageBox>
 #include <QDebug>
 #include <cmath>
+#include <limits>
 #include <QFileDialog>
 #include <QFile>
 #include <QTextStream>
@@ -31,11 +42,41 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QComboBox>
+#include <QDialog>
+#include <QTableWidget>
+#include <QDialogButtonBox>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QBuffer>
 #include <Eigen/Dense>
+#include <atomic>
+#include <vector>
+
+namespace {
+// 拟合并行计算数 (0 = 自动)
+std::atomic<int> s_evaluationThreadCount(0);
+
+// 差分进化探索阶段的网格插值误差上限 (只用于比较个体优劣，精修仍用默认精度)
+const double ExplorationGridTolerance = 1e-2;
+
+// 拟合停止原因的界面文字
+QString stopReasonText(ModelFitter::StopReason reason)
+{
+    switch (reason) {
+    case ModelFitter::TargetReached: return "误差达到目标";
+    case ModelFitter::MaxIterations: return "达到最大迭代次数";
+    case ModelFitter::NoProgress: return "阻尼过大仍无法下降";
+    case ModelFitter::Cancelled: return "用户停止";
+    case ModelFitter::EvaluationFailed: return "初始参数无法计算";
+    case ModelFitter::SmallGradient: return "梯度收敛";
+    case ModelFitter::SmallStep: return "步长收敛";
+    case ModelFitter::SmallReduction: return "误差下降收敛";
+    }
+    return QString();
+}
+}
 
 // ===========================================================================
 // 构造与析构
@@ -52,7 +93,8 @@ FittingWidget::FittingWidget(QWidget *parent) :
     m_projectModel(nullptr),
     m_plotTitle(nullptr),
     m_currentModelType(ModelManager::Model_1),
-    m_isFitting(false)
+    m_isFitting(false),
+    m_stopRequested(false)
 {
     // 加载 UI 布局
     ui->setupUi(this);
@@ -81,8 +123,10 @@ FittingWidget::FittingWidget(QWidget *parent) :
     connect(this, &FittingWidget::sigIterationUpdated, this, &FittingWidget::onIterationUpdate, Qt::QueuedConnection);
     // 2. 进度信号 -> 更新进度条
     connect(this, &FittingWidget::sigProgress, ui->progressBar, &QProgressBar::setValue);
+    // 2b. 迭代诊断信号 -> 更新状态标签
+    connect(this, &FittingWidget::sigIterationDiagnostics, ui->label_FitStatus, &QLabel::setText, Qt::QueuedConnection);
     // 3. 异步任务监视器完成信号 -> 处理拟合结束
-    connect(&m_watcher, &QFutureWatcher<void>::finished, this, &FittingWidget::onFitFinished);
+    connect(&m_watcher, &QFutureWatcher<void>::finished, this, [this]() { onFitFinished(); });
 
     // 连接权重滑块变化信号 -> 更新权重数值标签
     connect(ui->sliderWeight, &QSlider::valueChanged, this, &FittingWidget::onSliderWeightChanged);
@@ -438,9 +482,25 @@ void FittingWidget::on_btnRunFit_clicked() {
     QList<FitParameter> paramsCopy = m_paramChart->getParameters();
     double w = ui->sliderWeight->value() / 100.0;
 
+    ModelFitter::Options options;
+    options.broyden = (ui->comboFitMethod->currentIndex() == 1);
+    options.jacobian = ui->checkForwardDiff->isChecked() ? ModelFitter::ForwardDifference : ModelFitter::CentralDifference;
+    options.damping = ui->comboDamping->currentIndex() == 0 ? ModelFitter::NielsenDamping : ModelFitter::MarquardtDamping;
+    options.geodesic = ui->checkGeodesic->isChecked();
+    ui->label_FitStatus->clear();
+
+    ModelFitter::MultiStartOptions multiStart;
+    multiStart.starts = (ui->comboFitMethod->currentIndex() == 2) ? ui->spinStarts->value() : 1;
+    multiStart.polishCount = ui->spinPolish->value();
+    m_candidates.clear();
+
+    ModelFitter::EvolutionOptions evolution;
+    evolution.maxGenerations = (ui->comboFitMethod->currentIndex() == 3) ? ui->spinGenerations->value() : 0;
+    evolution.populationSize = ui->spinPopulation->value();
+
     // 使用 QtConcurrent 在后台线程运行拟合优化任务，避免阻塞 UI 主线程
-    (void)QtConcurrent::run([this, modelType, paramsCopy, w](){
-        runOptimizationTask(modelType, paramsCopy, w);
+    (void)QtConcurrent::run([this, modelType, paramsCopy, w, options, multiStart, evolution](){
+        runOptimizationTask(modelType, paramsCopy, w, options, multiStart, evolution);
     });
 }
 
@@ -591,8 +651,8 @@ void FittingWidget::on_btnExportChart_clicked() {
 /**
  * @brief 运行优化任务的入口函数
  */
-void FittingWidget::runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight) {
-    runLevenbergMarquardtOptimization(modelType, fitParams, weight);
+void FittingWidget::runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight, ModelFitter::Options options, ModelFitter::MultiStartOptions multiStart, ModelFitter::EvolutionOptions evolution) {
+    runLevenbergMarquardtOptimization(modelType, fitParams, weight, options, multiStart, evolution);
 }
 
 /**
@@ -600,15 +660,20 @@ void FittingWidget::runOptimizationTask(ModelManager::ModelType modelType, QList
  * @param modelType 模型类型
  * @param params 参数列表
  * @param weight 权重 (0~1)
+ * @param options 迭代设置 (Broyden 更新、差分方式、阻尼更新、测地加速)
+ * @param multiStart 多起点设置 (starts <= 1 时只从表格中的当前参数开始)
+ * @param evolution 差分进化设置 (maxGenerations <= 0 时不使用)
  */
-void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight) {
-    // 设置模型计算为低精度模式以提高迭代速度
-    if(m_modelManager) m_modelManager->setHighPrecision(false);
+void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight, ModelFitter::Options options, ModelFitter::MultiStartOptions multiStart, ModelFitter::EvolutionOptions evolution) {
+    // 迭代过程中模型计算使用低精度模式以提高速度 (精度随每次调用传入，不修改共享状态)
+    const bool iterHighPrecision = false;
 
-    // 1. 确定需要拟合的参数索引
+    // 1. 确定需要拟合的参数索引 (参数名只在此处解析一次，迭代中按参数块下标访问)
     QVector<int> fitIndices;
+    QVector<ModelParams::Id> fitIds;
     for(int i=0; i<params.size(); ++i) {
-        if(params[i].isFit) fitIndices.append(i);
+        int id = ModelParams::indexOf(params[i].name.toUtf8().constData());
+        if(params[i].isFit && id >= 0) { fitIndices.append(i); fitIds.append((ModelParams::Id)id); }
     }
     int nParams = fitIndices.size();
 
@@ -618,159 +683,195 @@ void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType mo
         return;
     }
 
-    // 2. 初始化算法参数
-    double lambda = 0.01;      // 阻尼因子 (initial damping factor)
-    int maxIter = 50;          // 最大迭代次数
-    double currentSSE = 1e15;  // 当前误差平方和 (Sum Squared Error)
-
-    // 构建参数映射表
-    QMap<QString, double> currentParamMap;
-    for(const auto& p : params) currentParamMap.insert(p.name, p.value);
+    // 构建参数块 (迭代中的复制与修改均不分配内存)
+    QMap<QString, double> initialMap;
+    for(const auto& p : params) initialMap.insert(p.name, p.value);
+    ModelParams currentParams = ModelSolver::toParams(initialMap);
 
     // 初始参数联动处理 (LfD = Lf / L)
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
-
-    // 3. 计算初始状态的残差和误差
-    QVector<double> residuals = calculateResiduals(currentParamMap, modelType, weight);
-    currentSSE = calculateSumSquaredError(residuals);
-
-    // 通知界面更新初始状态
-    ModelCurveData curve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
-
-    // 4. 迭代主循环
-    for(int iter = 0; iter < maxIter; ++iter) {
-        if(m_stopRequested) break; // 响应用户停止请求
-
-        // 收敛判据：如果均方误差足够小，提前结束
-        if (!residuals.isEmpty() && (currentSSE / residuals.size()) < 3e-3) break;
-
-        emit sigProgress(iter * 100 / maxIter);
-
-        // 计算雅可比矩阵 J (size: nResiduals x nParams)
-        QVector<QVector<double>> J = computeJacobian(currentParamMap, residuals, fitIndices, modelType, params, weight);
-        int nRes = residuals.size();
-
-        // 构造正规方程的近似 Hessian 矩阵 H = J^T * J 和 梯度向量 g = J^T * r
-        QVector<QVector<double>> H(nParams, QVector<double>(nParams, 0.0));
-        QVector<double> g(nParams, 0.0);
-
-        for(int k=0; k<nRes; ++k) {
-            for(int i=0; i<nParams; ++i) {
-                // 计算梯度 g
-                g[i] += J[k][i] * residuals[k];
-                // 计算 Hessian 的下三角部分
-                for(int j=0; j<=i; ++j) {
-                    H[i][j] += J[k][i] * J[k][j];
-                }
-            }
-        }
-        // 填充 Hessian 的对称部分 (上三角)
-        for(int i=0; i<nParams; ++i) {
-            for(int j=i+1; j<nParams; ++j) {
-                H[i][j] = H[j][i];
-            }
+    currentParams.updateDerived();
+
+    // 2. 计算初始误差并通知界面 (界面边界处转换回 QMap)
+    QVector<double> residuals = calculateResiduals(currentParams, modelType, weight);
+    const int nRes = qMax(1, residuals.size());
+    double initialSSE = 0.0;
+    for(double v : residuals) initialSSE += v*v;
+    ModelCurveData curve = m_modelManager->calculateTheoreticalCurve(modelType, currentParams, QVector<double>(), iterHighPrecision);
+    emit sigIterationUpdated(initialSSE/nRes, ModelSolver::toMap(currentParams), std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
+
+    // 3. 内部坐标: 对数敏感参数 (如 k, C) 取 log10，S 和 nf 取原值；上下限与差分步长换算到同一坐标
+    QVector<bool> isLog(nParams);
+    ModelFitter::Problem problem;
+    problem.lower.resize(nParams);
+    problem.upper.resize(nParams);
+    problem.steps.resize(nParams);
+    Eigen::VectorXd u0(nParams);
+    for(int i=0; i<nParams; ++i) {
+        const FitParameter& fp = params[fitIndices[i]];
+        double val = currentParams.value(fitIds[i]);
+        isLog[i] = (val > 1e-12 && fitIds[i] != ModelParams::S && fitIds[i] != ModelParams::Nf);
+        if(isLog[i]) {
+            u0[i] = log10(val);
+            problem.lower[i] = fp.min > 0.0 ? log10(fp.min) : -std::numeric_limits<double>::infinity();
+            problem.upper[i] = fp.max > 0.0 ? log10(fp.max) : u0[i];
+            problem.steps[i] = 0.01; // 对数域步长
+        } else {
+            u0[i] = val;
+            problem.lower[i] = fp.min;
+            problem.upper[i] = fp.max;
+            problem.steps[i] = 1e-4; // 线性域步长
         }
+    }
 
-        bool stepAccepted = false;
-
-        // 5. 内部循环：尝试更新步长 (Levenberg-Marquardt 核心步骤)
-        // 如果新误差变大，则增大阻尼因子 lambda 并重试
-        for(int tryIter=0; tryIter<5; ++tryIter) {
-            QVector<QVector<double>> H_lm = H;
-
-            // 将阻尼因子加入 Hessian 对角线: H_ii = H_ii + lambda * (1 + |H_ii|) 或 simplified: H_ii + lambda
-            // 这里采用 Marquardt 建议的方式
-            for(int i=0; i<nParams; ++i) {
-                H_lm[i][i] += lambda * (1.0 + std::abs(H[i][i]));
-            }
-
-            QVector<double> negG(nParams);
-            for(int i=0;i<nParams;++i) negG[i] = -g[i];
-
-            // 求解线性方程组 (H_lm * delta = -g) 得到参数更新量 delta
-            QVector<double> delta = solveLinearSystem(H_lm, negG);
-
-            // 计算试探性新参数
-            QMap<QString, double> trialMap = currentParamMap;
-            for(int i=0; i<nParams; ++i) {
-                int pIdx = fitIndices[i];
-                QString pName = params[pIdx].name;
-                double oldVal = currentParamMap[pName];
-
-                // 判断参数是否需要在对数域更新 (大部分试井参数如 k, C, S 为对数敏感，但 S 和 nf 除外)
-                bool isLog = (oldVal > 1e-12 && pName != "S" && pName != "nf");
-                double newVal;
-
-                if(isLog) {
-                    // 对数域更新: new = 10^(log(old) + delta)
-                    double logVal = log10(oldVal) + delta[i];
-                    newVal = pow(10.0, logVal);
-                } else {
-                    // 线性域更新: new = old + delta
-                    newVal = oldVal + delta[i];
-                }
-
-                // 强制约束参数范围 (Min/Max)
-                newVal = qMax(params[pIdx].min, qMin(newVal, params[pIdx].max));
-                trialMap[pName] = newVal;
-            }
+    auto toParams = [&](const Eigen::VectorXd& u) {
+        ModelParams p = currentParams;
+        for(int i=0; i<nParams; ++i) p.set(fitIds[i], isLog[i] ? pow(10.0, u[i]) : u[i]);
+        p.updateDerived();
+        return p;
+    };
+    auto toVector = [](const QVector<double>& r) {
+        return Eigen::VectorXd(Eigen::Map<const Eigen::VectorXd>(r.constData(), r.size()));
+    };
+
+    problem.residuals = [&](const Eigen::VectorXd& u, Eigen::VectorXd& r) {
+        QVector<double> res = calculateResiduals(toParams(u), modelType, weight);
+        r = toVector(res);
+        return !res.isEmpty();
+    };
+    // 雅可比矩阵的扰动点一次性并行计算
+    // (phi、mu、Ct、q、B、h 只缩放 tD 与压力，残差由缓存的无因次主曲线插值得到，不重新反演)
+    problem.batchResiduals = [&](const std::vector<Eigen::VectorXd>& us, std::vector<Eigen::VectorXd>& rs) {
+        QVector<ModelParams> sets;
+        sets.reserve((int)us.size());
+        for(const Eigen::VectorXd& u : us) sets.append(toParams(u));
+        QVector<QVector<double>> res = calculateResidualsBatch(sets, modelType, weight);
+        for(size_t i = 0; i < us.size(); ++i) rs[i] = toVector(res[(int)i]);
+    };
+    problem.shouldContinue = [&](int iter) {
+        if(m_stopRequested) return false; // 响应用户停止请求
+        emit sigProgress(iter * 100 / options.maxIterations);
+        return true;
+    };
+    problem.accepted = [&](const Eigen::VectorXd& u, double sse) {
+        // 刷新界面曲线
+        ModelParams p = toParams(u);
+        ModelCurveData iterCurve = m_modelManager->calculateTheoreticalCurve(modelType, p, QVector<double>(), iterHighPrecision);
+        emit sigIterationUpdated(sse/nRes, ModelSolver::toMap(p), std::get<0>(iterCurve), std::get<1>(iterCurve), std::get<2>(iterCurve));
+    };
+    problem.iterationDone = [&](const ModelFitter::Iteration& info) {
+        emit sigIterationDiagnostics(QString("第 %1 次迭代%2: λ=%3  |g|=%4  步长=%5  ρ=%6  模型计算 %7 次")
+                                         .arg(info.iteration + 1).arg(info.accepted ? "" : " (未下降)")
+                                         .arg(info.lambda, 0, 'e', 1).arg(info.gradientNorm, 0, 'e', 1)
+                                         .arg(info.stepNorm, 0, 'e', 1).arg(info.rho, 0, 'f', 2).arg(info.evaluations));
+    };
+
+    // 4. 迭代
+    QElapsedTimer timer;
+    timer.start();
+    ModelFitter::Report report;
+    QString multiStartText;
+    long long evolutionEvaluations = 0;
+    if(evolution.maxGenerations > 0) {
+        // 差分进化: 低精度残差只用于比较个体优劣
+        ModelFitter::Problem explore = problem;
+        explore.residuals = [&](const Eigen::VectorXd& u, Eigen::VectorXd& r) {
+            QVector<double> res = calculateResiduals(toParams(u), modelType, weight, ExplorationGridTolerance);
+            r = toVector(res);
+            return !res.isEmpty();
+        };
+        evolution.threadCount = evaluationThreadCount();
+        evolution.cancel = &m_stopRequested;
+        evolution.targetMSE = options.targetMSE;
+        evolution.generationDone = [&](int gen, const Eigen::VectorXd& best, double sse, bool improved) {
+            emit sigProgress((gen + 1) * 100 / evolution.maxGenerations);
+            emit sigIterationDiagnostics(QString("差分进化第 %1 代: 最好误差 %2").arg(gen + 1).arg(sse / nRes, 0, 'e', 3));
+            if(!improved) return;
+            // 最好个体改进时刷新图上曲线
+            ModelParams p = toParams(best);
+            ModelCurveData bestCurve = m_modelManager->calculateTheoreticalCurve(modelType, p, QVector<double>(), iterHighPrecision);
+            emit sigIterationUpdated(sse/nRes, ModelSolver::toMap(p), std::get<0>(bestCurve), std::get<1>(bestCurve), std::get<2>(bestCurve));
+        };
+        ModelFitter::EvolutionReport de = ModelFitter::differentialEvolution(u0, explore, evolution);
+        evolutionEvaluations = de.evaluations;
+        if(std::isfinite(de.sse)) u0 = de.u;
+        multiStartText = QString("差分进化: %1 代 × 种群 %2，模型计算 %3 次 (低精度)，最好误差 %4\n")
+                             .arg(de.generations).arg(de.populationSize).arg(de.evaluations)
+                             .arg(de.sse / nRes, 0, 'e', 3);
+    }
 
-            // 参数联动更新
-            if(trialMap.contains("L") && trialMap.contains("Lf") && trialMap["L"] > 1e-9)
-                trialMap["LfD"] = trialMap["Lf"] / trialMap["L"];
-
-            // 计算新参数下的残差和误差
-            QVector<double> newRes = calculateResiduals(trialMap, modelType, weight);
-            double newSSE = calculateSumSquaredError(newRes);
-
-            // 6. 评估更新结果
-            if(newSSE < currentSSE) {
-                // 成功：接受新参数，减小阻尼因子，进入下一次迭代
-                currentSSE = newSSE;
-                currentParamMap = trialMap;
-                residuals = newRes;
-                lambda /= 10.0;
-                stepAccepted = true;
-
-                // 刷新界面曲线
-                ModelCurveData iterCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-                emit sigIterationUpdated(currentSSE/nRes, currentParamMap, std::get<0>(iterCurve), std::get<1>(iterCurve), std::get<2>(iterCurve));
-                break;
-            } else {
-                // 失败：误差增加，拒绝更新，增大阻尼因子重试
-                lambda *= 10.0;
-            }
+    if(multiStart.starts > 1) {
+        // 多起点: 各起点并行迭代，界面只在结束时显示最好的候选解
+        multiStart.lm = options;
+        multiStart.threadCount = evaluationThreadCount();
+        multiStart.cancel = &m_stopRequested;
+        multiStart.progress = [this](int done, int total) { emit sigProgress(done * 100 / qMax(1, total)); };
+        ModelFitter::MultiStartReport ms = ModelFitter::multiStart(u0, problem, multiStart);
+
+        QVector<FitCandidate> candidates;
+        for(const ModelFitter::Candidate& c : ms.candidates) {
+            if(!std::isfinite(c.sse)) continue;
+            FitCandidate fc;
+            fc.mse = c.sse / nRes;
+            fc.start = c.start;
+            fc.polished = c.polished;
+            fc.reason = stopReasonText(c.reason);
+            fc.params = ModelSolver::toMap(toParams(c.u));
+            candidates.append(fc);
         }
-
-        // 如果 lambda 过大仍无法下降，认为已陷入局部极小值，终止
-        if(!stepAccepted && lambda > 1e10) break;
+        QStringList keys;
+        for(int idx : fitIndices) keys.append(params[idx].name);
+        m_candidateKeys = keys;
+        m_candidates = candidates;
+
+        if(!ms.candidates.empty()) {
+            const ModelFitter::Candidate& best = ms.candidates.front();
+            report.u = best.u;
+            report.sse = best.sse;
+            report.iterations = best.iterations;
+            report.reason = std::isfinite(best.sse) ? best.reason : ModelFitter::EvaluationFailed;
+        } else {
+            report.reason = ModelFitter::EvaluationFailed;
+        }
+        if(ms.cancelled) report.reason = ModelFitter::Cancelled;
+        report.residualCount = ms.residualCount;
+        report.evaluations = ms.evaluations;
+        multiStartText = QString("多起点: %1 个起点，精修 %2 个，最好的候选解来自起点 %3\n")
+                             .arg(multiStart.starts).arg(multiStart.polishCount)
+                             .arg(ms.candidates.empty() ? -1 : ms.candidates.front().start);
+    } else {
+        // 停止请求在进化阶段发出时，LM 立即返回，结果为进化的最好个体
+        report = ModelFitter::levenbergMarquardt(u0, problem, options);
     }
+    report.evaluations += evolutionEvaluations;
+    double seconds = timer.elapsed() / 1000.0;
 
-    // 7. 拟合结束处理
-    // 恢复高精度模式并计算最终曲线
-    if(m_modelManager) m_modelManager->setHighPrecision(true);
+    // 5. 拟合结束处理
+    // 使用高精度模式计算最终曲线
+    if(report.reason != ModelFitter::EvaluationFailed) currentParams = toParams(report.u);
+    double mse = report.residualCount > 0 ? report.sse / report.residualCount : 0.0;
 
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
+    ModelCurveData finalCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParams);
+    emit sigIterationUpdated(mse, ModelSolver::toMap(currentParams), std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
 
-    ModelCurveData finalCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
+    QString summary = multiStartText + QString("停止原因: %1\n迭代 %2 次，模型计算 %3 次 (差分 %4 次，完整差分 %5 次，Broyden 更新 %6 次，测地加速 %7 次)，用时 %8 s")
+                          .arg(stopReasonText(report.reason)).arg(report.iterations).arg(report.evaluations)
+                          .arg(report.jacobianEvaluations).arg(report.jacobianBuilds).arg(report.broydenUpdates)
+                          .arg(report.geodesicEvaluations).arg(seconds, 0, 'f', 2);
 
     // 通知主线程完成
-    QMetaObject::invokeMethod(this, "onFitFinished");
+    QMetaObject::invokeMethod(this, "onFitFinished", Q_ARG(QString, summary));
 }
 
 /**
  * @brief 计算残差向量
  * @return 包含压差残差和导数残差的向量
  */
-QVector<double> FittingWidget::calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight) {
+QVector<double> FittingWidget::calculateResiduals(const ModelParams& params, ModelManager::ModelType modelType, double weight, double gridTolerance) {
     if(!m_modelManager || m_obsTime.isEmpty()) return QVector<double>();
 
-    // 调用模型管理器计算理论曲线
-    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(modelType, params, m_obsTime);
+    // 调用模型管理器计算理论曲线: 模型在自适应对数粗网格上反演后插值到观测时间，
+    // 计算量与观测点数基本无关 (观测点较少或插值达不到误差要求时自动退化为逐点计算)
+    ModelCurveData res = m_modelManager->calculateInterpolatedCurve(modelType, params, m_obsTime, false, gridTolerance);
     const QVector<double>& pCal = std::get<1>(res);
     const QVector<double>& dpCal = std::get<2>(res);
 
@@ -800,90 +901,29 @@ QVector<double> FittingWidget::calculateResiduals(const QMap<QString, double>& p
     return r;
 }
 
-/**
- * @brief 计算雅可比矩阵 (数值微分法)
- * @return J 矩阵
- */
-QVector<QVector<double>> FittingWidget::computeJacobian(const QMap<QString, double>& params, const QVector<double>& baseResiduals, const QVector<int>& fitIndices, ModelManager::ModelType modelType, const QList<FitParameter>& currentFitParams, double weight) {
-    int nRes = baseResiduals.size();
-    int nParams = fitIndices.size();
-    QVector<QVector<double>> J(nRes, QVector<double>(nParams));
-
-    for(int j = 0; j < nParams; ++j) {
-        int idx = fitIndices[j];
-        QString pName = currentFitParams[idx].name;
-        double val = params.value(pName);
-        bool isLog = (val > 1e-12 && pName != "S" && pName != "nf");
-
-        // 计算中心差分步长 h
-        double h;
-        QMap<QString, double> pPlus = params;
-        QMap<QString, double> pMinus = params;
-
-        if(isLog) {
-            h = 0.01; // 对数域步长
-            double valLog = log10(val);
-            pPlus[pName] = pow(10.0, valLog + h);
-            pMinus[pName] = pow(10.0, valLog - h);
-        } else {
-            h = 1e-4; // 线性域步长
-            pPlus[pName] = val + h;
-            pMinus[pName] = val - h;
-        }
-
-        // 联动更新
-        auto updateDeps = [](QMap<QString,double>& map) { if(map.contains("L") && map.contains("Lf") && map["L"] > 1e-9) map["LfD"] = map["Lf"] / map["L"]; };
-        if(pName == "L" || pName == "Lf") { updateDeps(pPlus); updateDeps(pMinus); }
-
-        // 分别计算正向扰动和负向扰动的残差
-        QVector<double> rPlus = calculateResiduals(pPlus, modelType, weight);
-        QVector<double> rMinus = calculateResiduals(pMinus, modelType, weight);
-
-        // 中心差分公式: df/dx = (f(x+h) - f(x-h)) / 2h
-        if(rPlus.size() == nRes && rMinus.size() == nRes) {
-            for(int i=0; i<nRes; ++i) {
-                J[i][j] = (rPlus[i] - rMinus[i]) / (2.0 * h);
-            }
-        }
-    }
-    return J;
+void FittingWidget::setEvaluationThreadCount(int count)
+{
+    s_evaluationThreadCount.store(count < 0 ? 0 : count);
 }
 
-/**
- * @brief 求解线性方程组 Ax = b
- * 说明：使用 Eigen 库的 LDLT 分解求解对称正定矩阵，稳定性好。
- */
-QVector<double> FittingWidget::solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b) {
-    int n = b.size();
-    if (n == 0) return QVector<double>();
-
-    Eigen::MatrixXd matA(n, n);
-    Eigen::VectorXd vecB(n);
-
-    // 将 QVector 转换为 Eigen 数据格式
-    for (int i = 0; i < n; ++i) {
-        vecB(i) = b[i];
-        for (int j = 0; j < n; ++j) {
-            matA(i, j) = A[i][j];
-        }
-    }
-
-    // 求解
-    Eigen::VectorXd x = matA.ldlt().solve(vecB);
-
-    // 转换回 QVector
-    QVector<double> res(n);
-    for (int i = 0; i < n; ++i) res[i] = x(i);
-    return res;
+int FittingWidget::evaluationThreadCount()
+{
+    int n = s_evaluationThreadCount.load();
+    if (n > 0) return n;
+    return qMax(1, ModelThreadPool::idealThreadCount() - 1);
 }
 
 /**
- * @brief 计算误差平方和 (SSE)
+ * @brief 并行计算多组参数的残差
+ * 说明：各组分配到内核线程池，工作线程内的模型反演自动串行，不会过度占用核心；
+ *       计算服务 (ModelSolver 及其缓存) 可重入，观测数据在拟合期间只读。
  */
-double FittingWidget::calculateSumSquaredError(const QVector<double>& residuals) {
-    double sse = 0.0;
-    for(double v : residuals) sse += v*v;
-    return sse;
+QVector<QVector<double>> FittingWidget::calculateResidualsBatch(const QVector<ModelParams>& paramSets, ModelManager::ModelType modelType, double weight) {
+    std::vector<QVector<double>> results(paramSets.size());
+    ModelThreadPool::instance().parallelFor(paramSets.size(), evaluationThreadCount(), [&](int i) {
+        results[i] = calculateResiduals(paramSets[i], modelType, weight);
+    });
+    return QVector<QVector<double>>(results.begin(), results.end());
 }
 
 // ===========================================================================
@@ -950,10 +990,71 @@ void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
 /**
  * @brief 拟合完成槽函数
  */
-void FittingWidget::onFitFinished() {
+void FittingWidget::onFitFinished(const QString& summary) {
     m_isFitting = false;
     ui->btnRunFit->setEnabled(true);
-    QMessageBox::information(this, "完成", "拟合完成。");
+    QMessageBox::information(this, "完成", summary.isEmpty() ? QString("拟合完成。") : QString("拟合完成。\n%1").arg(summary));
+    if(m_candidates.size() > 1) showCandidates();
+}
+
+/**
+ * @brief 显示多起点拟合的候选解
+ * 说明：按误差排序，列出起点序号、是否精修、停止原因和各拟合参数；双击或点击“采用”更新参数表与曲线。
+ */
+void FittingWidget::showCandidates() {
+    QDialog dlg(this);
+    dlg.setWindowTitle("多起点拟合候选解");
+    dlg.resize(800, 400);
+    QVBoxLayout* layout = new QVBoxLayout(&dlg);
+
+    QTableWidget* table = new QTableWidget(m_candidates.size(), 4 + m_candidateKeys.size(), &dlg);
+    QStringList headers = {"误差(MSE)", "起点", "精修", "停止原因"};
+    headers << m_candidateKeys;
+    table->setHorizontalHeaderLabels(headers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::SingleSelection);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    for(int i = 0; i < m_candidates.size(); ++i) {
+        const FitCandidate& c = m_candidates[i];
+        table->setItem(i, 0, new QTableWidgetItem(QString::number(c.mse, 'e', 3)));
+        table->setItem(i, 1, new QTableWidgetItem(c.start == 0 ? QString("当前参数") : QString::number(c.start)));
+        table->setItem(i, 2, new QTableWidgetItem(c.polished ? "是" : ""));
+        table->setItem(i, 3, new QTableWidgetItem(c.reason));
+        for(int k = 0; k < m_candidateKeys.size(); ++k)
+            table->setItem(i, 4 + k, new QTableWidgetItem(QString::number(c.params.value(m_candidateKeys[k]), 'g', 5)));
+    }
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    table->selectRow(0);
+    layout->addWidget(table);
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(&dlg);
+    QPushButton* btnApply = buttons->addButton("采用所选", QDialogButtonBox::ActionRole);
+    buttons->addButton(QDialogButtonBox::Close);
+    layout->addWidget(buttons);
+
+    auto applySelected = [this, table]() {
+        int row = table->currentRow();
+        if(row >= 0) applyCandidate(row);
+    };
+    connect(btnApply, &QPushButton::clicked, &dlg, applySelected);
+    connect(table, &QTableWidget::cellDoubleClicked, &dlg, applySelected);
+    connect(buttons, &QDialogButtonBox::rejected, &dlg, &QDialog::reject);
+    dlg.exec();
+}
+
+/**
+ * @brief 采用候选解的参数并刷新曲线
+ */
+void FittingWidget::applyCandidate(int index) {
+    if(index < 0 || index >= m_candidates.size() || !m_modelManager) return;
+    const FitCandidate& c = m_candidates[index];
+    QVector<double> targetT = m_obsTime;
+    if(targetT.isEmpty()) {
+        for(double e = -4; e <= 4; e += 0.1) targetT.append(pow(10, e));
+    }
+    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(m_currentModelType, c.params, targetT);
+    onIterationUpdate(c.mse, c.params, std::get<0>(res), std::get<1>(res), std::get<2>(res));
+    m_paramChart->updateParamsFromTable();
 }
 
 /**
@@ -6,6 +6,11 @@
  * 2. 声明用于Levenberg-Marquardt非线性回归拟合的核心算法函数。
  * 3. 声明观测数据（时间、压差、导数）的管理函数。
  * 4. 提供与外部模块（如主窗口、模型管理器）的交互接口。
+ * 5. 雅可比矩阵各列的扰动残差在内核线程池中并行计算，并行数由系统设置页限定。
+ * 6. 迭代算法由 ModelFitter 提供 (LM，可选 Broyden 秩一更新、前向差分、Nielsen 阻尼与测地加速)，
+ *    界面选择后随任务传入；每次迭代的诊断信息经信号送回界面。
+ * 7. 多起点模式: 起点在参数上下限内拉丁超立方抽样并行拟合，结束后列出按误差排序的候选解供选用。
+ * 8. 差分进化模式: 以放宽插值误差的低精度模型做全局搜索 (每代个体并行计算)，最好个体交给 LM 精修。
  */
 
 #ifndef WT_FITTINGWIDGET_H
@@ -17,7 +22,9 @@
 #include <QFutureWatcher>
 #include <QJsonObject>
 #include <QStandardItemModel>
+#include <atomic>
 #include "modelmanager.h"
+#include "modelfitter.h"
 #include "mousezoom.h"
 #include "chartsetting1.h"
 #include "fittingparameterchart.h"
@@ -54,6 +61,11 @@ public:
     // 获取当前拟合界面的所有状态为JSON对象，用于保存项目
     QJsonObject getJsonState() const;
 
+    // 拟合中同时计算的残差组数上限 (进程级，由系统设置页配置)
+    // <=0 为自动: 全部核心减一，保留一个核心给界面线程
+    static void setEvaluationThreadCount(int count);
+    static int evaluationThreadCount();
+
 signals:
     // 拟合计算完成信号，携带最终模型类型和参数
     void fittingCompleted(ModelManager::ModelType modelType, const QMap<QString, double>& parameters);
@@ -64,6 +76,9 @@ signals:
     // 进度条更新信号
     void sigProgress(int progress);
 
+    // 迭代诊断信号 (阻尼因子、梯度、步长等的文字说明)
+    void sigIterationDiagnostics(const QString& text);
+
     // 请求父级页面保存项目的信号
     void sigRequestSave();
 
@@ -110,8 +125,8 @@ private slots:
     // 内部逻辑槽：处理迭代更新信号，刷新UI
     void onIterationUpdate(double err, const QMap<QString,double>& p, const QVector<double>& t, const QVector<double>& p_curve, const QVector<double>& d_curve);
 
-    // 内部逻辑槽：处理拟合完成后的收尾工作
-    void onFitFinished();
+    // 内部逻辑槽：处理拟合完成后的收尾工作 (summary 为迭代与模型计算次数统计)
+    void onFitFinished(const QString& summary = QString());
 
     // 内部逻辑槽：处理权重滑块数值变更
     void onSliderWeightChanged(int value);
@@ -134,9 +149,21 @@ private:
 
     // 拟合任务控制状态
     bool m_isFitting;                      // 是否正在拟合中
-    bool m_stopRequested;                  // 是否收到了停止请求
+    std::atomic<bool> m_stopRequested;     // 是否收到了停止请求 (多起点拟合的各工作线程同时读取)
     QFutureWatcher<void> m_watcher;        // 异步任务监视器
 
+    // 多起点拟合的候选解 (拟合线程结束前写入，onFitFinished 中读取)
+    struct FitCandidate
+    {
+        double mse = 0.0;
+        int start = 0;                     // 起点序号 (0 为表格中的当前参数)
+        bool polished = false;             // 是否经过完整迭代
+        QString reason;                    // 停止原因
+        QMap<QString, double> params;
+    };
+    QVector<FitCandidate> m_candidates;
+    QStringList m_candidateKeys;           // 候选表中显示的参数 (参与拟合的参数)
+
     // 初始化绘图控件的样式和布局
     void setupPlot();
 
@@ -147,22 +174,24 @@ private:
     void updateModelCurve();
 
     // 启动非线性回归优化任务（在子线程运行）
-    void runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight);
+    void runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight, ModelFitter::Options options, ModelFitter::MultiStartOptions multiStart, ModelFitter::EvolutionOptions evolution);
 
-    // Levenberg-Marquardt 算法的具体实现
-    void runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight);
+    // Levenberg-Marquardt 算法的具体实现 (参数换算与界面通知，迭代由 ModelFitter 完成)
+    // multiStart.starts > 1 时为多起点拟合；evolution.maxGenerations > 0 时先做差分进化，再从最好个体开始 LM
+    void runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight, ModelFitter::Options options, ModelFitter::MultiStartOptions multiStart, ModelFitter::EvolutionOptions evolution);
 
-    // 计算当前参数下的残差向量（理论值与观测值的差异）
-    QVector<double> calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight);
+    // 显示多起点拟合的候选解列表，选中后可采用其参数
+    void showCandidates();
 
-    // 计算雅可比矩阵（残差对各个待拟合参数的偏导数）
-    QVector<QVector<double>> computeJacobian(const QMap<QString, double>& params, const QVector<double>& residuals, const QVector<int>& fitIndices, ModelManager::ModelType modelType, const QList<FitParameter>& currentFitParams, double weight);
+    // 采用第 index 个候选解: 更新参数表与曲线
+    void applyCandidate(int index);
 
-    // 求解线性方程组 (Ax = b)，用于LM算法中的迭代步长计算
-    QVector<double> solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b);
+    // 计算当前参数下的残差向量（理论值与观测值的差异）
+    // gridTolerance: 理论曲线网格插值的相对误差上限 (差分进化探索阶段放宽)
+    QVector<double> calculateResiduals(const ModelParams& params, ModelManager::ModelType modelType, double weight, double gridTolerance = ModelSolver::DefaultGridTolerance);
 
-    // 计算残差平方和（SSE），作为目标函数值
-    double calculateSumSquaredError(const QVector<double>& residuals);
+    // 并行计算一组参数块的残差 (结果顺序与 paramSets 一致，与并行数无关)
+    QVector<QVector<double>> calculateResidualsBatch(const QVector<ModelParams>& paramSets, ModelManager::ModelType modelType, double weight);
 
     // 获取图表的Base64编码字符串，用于生成HTML报告
     QString getPlotImageBase64();